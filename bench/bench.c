@@ -0,0 +1,332 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <stdatomic.h>
+#include "bench.h"
+#include "prng.h"
+
+// glibc의 실제 할당 함수. 아래의 malloc 계열이 이것들을 감싸며 횟수를 셉니다.
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t n, size_t size);
+extern void* __libc_realloc(void* p, size_t size);
+extern void* __libc_memalign(size_t align, size_t size);
+extern void __libc_free(void* p);
+
+static atomic_long allocations;
+
+void* malloc(size_t size) {
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size) {
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    return __libc_calloc(n, size);
+}
+
+void* realloc(void* p, size_t size) {
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    return __libc_realloc(p, size);
+}
+
+void* aligned_alloc(size_t align, size_t size) {
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    return __libc_memalign(align, size);
+}
+
+int posix_memalign(void** out, size_t align, size_t size) {
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    *out = __libc_memalign(align, size);
+    return *out ? 0 : 12;
+}
+
+void free(void* p) {
+    __libc_free(p);
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 최대 RSS(VmHWM)를 현재 RSS로 되돌립니다. 경우마다 따로 재기 위함입니다.
+static void resetPeakRSS(void) {
+    FILE* f = fopen("/proc/self/clear_refs", "w");
+    if (f != NULL) {
+        fputs("5", f);
+        fclose(f);
+    }
+}
+
+static long peakRSS(void) {
+    FILE* f = fopen("/proc/self/status", "r");
+    long kb = -1;
+    char line[256];
+    while (f != NULL && fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "VmHWM:", 6) == 0) {
+            kb = strtol(line + 6, NULL, 10);
+            break;
+        }
+    }
+    if (f != NULL) {
+        fclose(f);
+    }
+    return kb;
+}
+
+// "64,256,1024" 같은 목록을 읽습니다.
+static int parseList(const char* s, double* out, int max) {
+    int n = 0;
+    char* end;
+    while (*s && n < max) {
+        out[n++] = strtod(s, &end);
+        s = *end == ',' ? end + 1 : end;
+        if (end == s && *s != '\0') {
+            break;
+        }
+    }
+    return n;
+}
+
+typedef struct {
+    bool ok;
+    int received;        // 처음 풀린 기호 수 (손실된 기호 제외)
+    int encoded;         // 만든 기호 수 (손실된 기호 포함)
+    double encodeTime;
+    double decodeTime;
+    long encodeAllocs;
+    long decodeAllocs;
+    long peakKB;
+} benchResult;
+
+// 손실 모델: ID마다 정해지는 독립 손실이라 반복해도 같은 기호가 빠집니다.
+static bool lost(uint64_t seed, int64_t id, double loss) {
+    return (double)(splitmix64(seed ^ (uint64_t)id) >> 11) * 0x1.0p-53 < loss;
+}
+
+// 손실되지 않은 처음 n개 기호를 새 디코더에 한꺼번에 넣고 풀리는지 봅니다.
+// runCase가 찾은 문턱을 좁히는 데만 쓰며 시간과 할당은 재지 않습니다.
+static bool decodesWith(const benchCodec* codec, void* state, int k, int symbolSize, int n, double loss, uint64_t seed,
+                        const uint8_t* message, size_t length) {
+    int64_t* ids = (int64_t*)malloc(n * sizeof(int64_t));
+    uint8_t* symbols = (uint8_t*)malloc((size_t)n * symbolSize);
+    uint8_t* output = (uint8_t*)malloc((size_t)k * symbolSize);
+    for (int64_t id = 0, i = 0; i < n; id++) {
+        if (!lost(seed, id, loss)) {
+            ids[i++] = id;
+        }
+    }
+    codec->encode(state, ids, n, symbols);
+    void* decoder = codec->newDecoder(state, output);
+    bool ok = codec->add(decoder, ids, symbols, n) && codec->decode(decoder, output) &&
+              memcmp(output, message, length) == 0;
+    codec->freeDecoder(decoder);
+    free(output);
+    free(symbols);
+    free(ids);
+    return ok;
+}
+
+// 한 경우를 잽니다. 메시지는 k * symbolSize - trim 바이트라 trim > 0이면 k로
+// 나누어떨어지지 않아 짧은 블록의 채움 경로를 탑니다. 기호는 k/8개씩 필요할 때만 만들어 인코딩 시간에 넣고,
+// 손실되지 않은 것만 디코더에 넣습니다. 디코더가 풀이할 만하다고 하면 풀어 보고,
+// 실패하면 k의 1%씩 더 넣습니다. 기호가 ceil(3k / (1 - loss)) + 64개를 넘도록
+// 풀리지 않으면 실패로 봅니다. 시간은 이 1% 격자로 재지만, received는 마지막으로
+// 실패한 수와 처음 성공한 수 사이를 새 디코더로 이분 탐색해 처음 풀리는 기호 수를
+// 적습니다.
+static benchResult runCase(const benchCodec* codec, int k, int symbolSize, int trim, double loss, uint64_t seed) {
+    benchResult r = {0};
+    size_t length = (size_t)k * symbolSize - trim;
+    uint8_t* message = (uint8_t*)malloc(length);
+    uint8_t* output = (uint8_t*)malloc((size_t)k * symbolSize);
+    counterRng rng;
+    counterRngInit(&rng, seed, k);
+    for (size_t i = 0; i < length; i += 8) {
+        uint64_t x = counterRngNext(&rng);
+        memcpy(message + i, &x, length - i < 8 ? length - i : 8);
+    }
+
+    int chunk = k / 8 > 0 ? k / 8 : 1;
+    int step = k / 100 > 0 ? k / 100 : 1;
+    int budget = (int)ceil(3.0 * k / (1.0 - loss)) + 64;
+    int64_t* ids = (int64_t*)malloc(chunk * sizeof(int64_t));
+    int64_t* kept = (int64_t*)malloc(chunk * sizeof(int64_t));
+    uint8_t* symbols = (uint8_t*)malloc((size_t)chunk * symbolSize);
+
+    resetPeakRSS();
+    long allocs = atomic_load(&allocations);
+    double t = now();
+    void* state = codec->create(k, message, length);
+    r.encodeTime += now() - t;
+    r.encodeAllocs += atomic_load(&allocations) - allocs;
+
+    allocs = atomic_load(&allocations);
+    t = now();
+    void* decoder = codec->newDecoder(state, output);
+    r.decodeTime += now() - t;
+    r.decodeAllocs += atomic_load(&allocations) - allocs;
+
+    int next = 0;
+    int failed = 0;  // 풀리지 않는다고 확인한 가장 큰 received
+    while (!r.ok && r.encoded < budget) {
+        int n = budget - r.encoded < chunk ? budget - r.encoded : chunk;
+        for (int i = 0; i < n; i++) {
+            ids[i] = r.encoded + i;
+        }
+        allocs = atomic_load(&allocations);
+        t = now();
+        codec->encode(state, ids, n, symbols);
+        r.encodeTime += now() - t;
+        r.encodeAllocs += atomic_load(&allocations) - allocs;
+        r.encoded += n;
+
+        // 손실되지 않은 기호를 앞으로 모읍니다.
+        int m = 0;
+        for (int i = 0; i < n; i++) {
+            if (!lost(seed, ids[i], loss)) {
+                kept[m] = ids[i];
+                memmove(symbols + (size_t)m * symbolSize, symbols + (size_t)i * symbolSize, symbolSize);
+                m++;
+            }
+        }
+
+        allocs = atomic_load(&allocations);
+        t = now();
+        for (int i = 0; i < m && !r.ok;) {
+            int want = next > r.received ? next - r.received : step;
+            int add = m - i < want ? m - i : want;
+            bool ready = codec->add(decoder, kept + i, symbols + (size_t)i * symbolSize, add);
+            r.received += add;
+            i += add;
+            if (!ready) {
+                failed = r.received;
+            } else if (r.received >= next) {
+                r.ok = codec->decode(decoder, output);
+                failed = r.ok ? failed : r.received;
+                next = r.received + step;
+            }
+        }
+        r.decodeTime += now() - t;
+        r.decodeAllocs += atomic_load(&allocations) - allocs;
+    }
+    r.ok = r.ok && memcmp(output, message, length) == 0;
+    r.peakKB = peakRSS();
+    if (decoderStatsEnabled() && codec->stats != NULL) {
+        char line[1024];
+        formatDecoderStats(line, sizeof(line), codec->name, codec->stats(decoder));
+        fputs(line, stderr);
+    }
+
+    for (int lo = failed, hi = r.received; r.ok && hi - lo > 1;) {
+        int mid = lo + (hi - lo) / 2;
+        if (decodesWith(codec, state, k, symbolSize, mid, loss, seed, message, length)) {
+            r.received = hi = mid;
+        } else {
+            lo = mid;
+        }
+    }
+
+    codec->freeDecoder(decoder);
+    codec->destroy(state);
+    free(symbols);
+    free(kept);
+    free(ids);
+    free(output);
+    free(message);
+    return r;
+}
+
+static void usage(const char* name) {
+    fprintf(stderr,
+            "usage: %s [-k list] [-t list] [-p list] [-l list] [-r reps] [-m max-bytes] [-s seed]\n"
+            "  -k  source symbol counts (default 64,256,1024,4096,8192)\n"
+            "  -t  symbol sizes in bytes (default 64,1024,16384,65536)\n"
+            "  -p  bytes cut from the k * symbol message, below k (default 0,3)\n"
+            "  -l  loss rates (default 0,0.1,0.3)\n"
+            "  -r  repetitions per case (default 1)\n"
+            "  -m  skip cases whose message exceeds this many bytes (default 64 MiB)\n",
+            name);
+}
+
+int benchMain(const benchCodec* codec, int argc, char** argv) {
+    double ks[32] = {64, 256, 1024, 4096, 8192};
+    double ts[32] = {64, 1024, 16384, 65536};
+    double trims[32] = {0, 3};
+    double losses[32] = {0, 0.1, 0.3};
+    int numK = 5, numT = 4, numTrim = 2, numLoss = 3, reps = 1;
+    double maxBytes = 64.0 * 1024 * 1024;
+    uint64_t seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = i + 1 < argc ? argv[i + 1] : NULL;
+        if (arg == NULL) {
+            usage(argv[0]);
+            return 2;
+        }
+        if (strcmp(argv[i], "-k") == 0) {
+            numK = parseList(arg, ks, 32);
+        } else if (strcmp(argv[i], "-t") == 0) {
+            numT = parseList(arg, ts, 32);
+        } else if (strcmp(argv[i], "-p") == 0) {
+            numTrim = parseList(arg, trims, 32);
+        } else if (strcmp(argv[i], "-l") == 0) {
+            numLoss = parseList(arg, losses, 32);
+        } else if (strcmp(argv[i], "-r") == 0) {
+            reps = atoi(arg);
+        } else if (strcmp(argv[i], "-m") == 0) {
+            maxBytes = strtod(arg, NULL);
+        } else if (strcmp(argv[i], "-s") == 0) {
+            seed = strtoull(arg, NULL, 10);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+
+    for (int a = 0; a < numK; a++) {
+        int k = (int)ks[a];
+        if (k <= 0 || (codec->maxK > 0 && k > codec->maxK)) {
+            continue;
+        }
+        for (int b = 0; b < numT; b++) {
+            int symbolSize = (int)ts[b];
+            if (symbolSize <= 0 || (double)k * symbolSize > maxBytes) {
+                continue;
+            }
+            for (int p = 0; p < numTrim; p++) {
+                // 기호 길이가 그대로이도록 k보다 적게만 잘라냅니다.
+                int trim = (int)trims[p];
+                if (trim < 0 || trim >= k) {
+                    continue;
+                }
+                size_t length = (size_t)k * symbolSize - trim;
+                for (int c = 0; c < numLoss; c++) {
+                    double loss = losses[c];
+                    if (loss < 0 || loss >= 1) {
+                        continue;
+                    }
+                    for (int rep = 0; rep < reps; rep++) {
+                        benchResult r = runCase(codec, k, symbolSize, trim, loss, seed + rep);
+                        double mb = (double)length / 1e6;
+                        double encodedMB = (double)r.encoded * symbolSize / 1e6;
+                        printf("{\"codec\":\"%s\",\"k\":%d,\"symbol\":%d,\"length\":%zu,\"loss\":%.3f,\"rep\":%d,\"ok\":%s,"
+                               "\"encode_mbps\":%.2f,\"decode_mbps\":%.2f,\"received\":%d,\"overhead\":%.4f,"
+                               "\"peak_rss_kb\":%ld,\"enc_allocs_per_symbol\":%.3f,\"dec_allocs_per_symbol\":%.3f}\n",
+                               codec->name, k, symbolSize, length, loss, rep, r.ok ? "true" : "false",
+                               r.encodeTime > 0 ? encodedMB / r.encodeTime : 0.0,
+                               r.ok && r.decodeTime > 0 ? mb / r.decodeTime : 0.0,
+                               r.received, r.ok ? (double)(r.received - k) / k : -1.0,
+                               r.peakKB, (double)r.encodeAllocs / (r.encoded > 0 ? r.encoded : 1),
+                               (double)r.decodeAllocs / (r.received > 0 ? r.received : 1));
+                        fflush(stdout);
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,52 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "stats.h"
+
+// 코덱 벤치마크. 코덱마다 bench_<codec>.c가 benchCodec 어댑터 하나와 main을
+// 두고, 측정과 출력은 bench.c가 맡습니다. raptor, ru10, online 헤더는 같은
+// 이름의 함수를 서로 다르게 선언하므로 코덱마다 실행 파일을 따로 만듭니다.
+//
+//   S="src/xor.c src/gf2.c src/gf256.c src/arena.c src/symbols.c src/alias.c src/pool.c"
+//   S="$S src/sample.c src/soliton.c src/inactivation.c src/mersenne.c src/stats.c"
+//   cc -O2 -Iinclude -Isrc bench/bench.c bench/bench_luby.c src/luby.c $S -lm -lpthread -o bench_luby
+//   cc -O2 -Iinclude -Isrc bench/bench.c bench/bench_raptor.c src/raptor.c src/fountain.c $S -lm -lpthread -o bench_raptor
+//   cc -O2 -Iinclude -Isrc bench/bench.c bench/bench_raptorq.c src/raptorq.c $S -lm -lpthread -o bench_raptorq
+//   cc -O2 -Iinclude -Isrc bench/bench.c bench/bench_ru10.c src/ru10.c $S -lm -lpthread -o bench_ru10
+//   cc -O2 -Iinclude -Isrc bench/bench.c bench/bench_online.c src/online.c $S -lm -lpthread -o bench_online
+//   cc -O2 -Iinclude -Isrc bench/bench.c bench/bench_binary.c src/binary.c src/block.c $S -lm -lpthread -o bench_binary
+//
+//   ./bench_luby -k 256,1024 -t 1024 -l 0,0.2 -r 3 >> bench_output.txt
+//
+// 경우마다 JSON 한 줄을 씁니다: codec, k, symbol, length, loss, rep, ok, encode_mbps,
+// decode_mbps, received, overhead, peak_rss_kb, enc_allocs_per_symbol,
+// dec_allocs_per_symbol. 할당 수는 glibc의 malloc 계열을 가로채 셉니다.
+// -DFOUNTAIN_STATS로 빌드하면 경우마다 디코더 카운터(stats.h)를 JSON 한 줄로
+// stderr에 씁니다.
+
+// benchCodec 구조체: 벤치마크가 코덱을 다루는 공통 인터페이스
+typedef struct {
+    const char* name;
+    int maxK;  // 이보다 큰 k는 건너뜀 (0이면 제한 없음)
+    // 메시지로 인코더 상태를 만듭니다 (중간 블록 생성 포함).
+    void* (*create)(int k, const uint8_t* message, size_t length);
+    // ids의 기호 n개를 out에 이어서 씁니다. 기호 길이는 ceil(length / k)입니다.
+    void (*encode)(void* state, const int64_t* ids, int n, uint8_t* out);
+    // out은 디코딩 결과를 받을 버퍼 (k * 기호 길이 바이트). 그 자리에 바로 푸는
+    // 코덱(luby)만 여기서 쓰고, 나머지는 decode에서 받습니다.
+    void* (*newDecoder)(void* state, uint8_t* out);
+    // 기호를 추가하고, 풀이를 시도할 만큼 모였으면 true
+    bool (*add)(void* decoder, const int64_t* ids, const uint8_t* symbols, int n);
+    bool (*decode)(void* decoder, uint8_t* out);
+    void (*freeDecoder)(void* decoder);
+    void (*destroy)(void* state);
+    const decoderStats* (*stats)(void* decoder);
+} benchCodec;
+
+// 함수 선언
+int benchMain(const benchCodec* codec, int argc, char** argv);
+
+#endif // BENCH_H
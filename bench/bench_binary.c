@@ -0,0 +1,105 @@
+#include <stdlib.h>
+#include "bench.h"
+#include "binary.h"
+#include "xor.h"
+
+// 이진 코덱. 카운터 PRNG("binary")와 기본값인 libc rand()("binary-libc")를 차례로
+// 잽니다. 기호마다 원본 블록의 절반 정도를 XOR하므로 인코딩이 O(k)이고 디코딩이
+// 밀집 소거라, 기본 범위에서는 k를 2048까지만 잽니다. srand(id) 뒤 rand() % 2로
+// 만든 행은 랭크가 500 근처에서 멈추므로 binary-libc는 그보다 큰 k를 풀지 못하고
+// ok=false로 나옵니다.
+typedef struct {
+    binaryCodec* codec;
+    symbolMatrix* intermediate;
+    int* indices;
+    const uint8_t** srcs;
+    int length;
+} binaryState;
+
+typedef struct {
+    binaryDecoder* decoder;
+    int symbolSize;
+} binaryBenchDecoder;
+
+static void* createState(binaryCodec* codec, int k, const uint8_t* message, size_t length) {
+    binaryState* s = (binaryState*)malloc(sizeof(binaryState));
+    s->codec = codec;
+    s->intermediate = GenerateIntermediateBlocks(s->codec, (uint8_t*)message, (int)length, k);
+    s->indices = (int*)malloc(k * sizeof(int));
+    s->srcs = (const uint8_t**)malloc(k * sizeof(uint8_t*));
+    s->length = (int)length;
+    return s;
+}
+
+static void* binaryCreate(int k, const uint8_t* message, size_t length) {
+    return createState(NewBinaryCodecSeeded(k, 7), k, message, length);
+}
+
+static void* binaryCreateLibc(int k, const uint8_t* message, size_t length) {
+    return createState(NewBinaryCodec(k), k, message, length);
+}
+
+static void binaryEncode(void* state, const int64_t* ids, int n, uint8_t* out) {
+    binaryState* s = (binaryState*)state;
+    const symbolMatrix* c = s->intermediate;
+    for (int i = 0; i < n; i++) {
+        int count = PickIndicesInto(s->codec, ids[i], s->indices);
+        for (int j = 0; j < count; j++) {
+            s->srcs[j] = symbolAt(c, s->indices[j]);
+        }
+        xorBytesGather(out + (size_t)i * c->symbolSize, s->srcs, count, c->symbolSize);
+    }
+}
+
+static void* binaryNewDecoder(void* state, uint8_t* out) {
+    (void)out;
+    binaryState* s = (binaryState*)state;
+    binaryBenchDecoder* d = (binaryBenchDecoder*)malloc(sizeof(binaryBenchDecoder));
+    d->decoder = NewDecoder(s->codec, s->length);
+    d->symbolSize = s->intermediate->symbolSize;
+    return d;
+}
+
+static bool binaryAdd(void* decoder, const int64_t* ids, const uint8_t* symbols, int n) {
+    binaryBenchDecoder* d = (binaryBenchDecoder*)decoder;
+    LTBlock* blocks = (LTBlock*)malloc(n * sizeof(LTBlock));
+    for (int i = 0; i < n; i++) {
+        blocks[i].blockCode = ids[i];
+        blocks[i].data = (uint8_t*)symbols + (size_t)i * d->symbolSize;
+        blocks[i].length = d->symbolSize;
+    }
+    bool ready = AddBlocks(d->decoder, blocks, n);
+    free(blocks);
+    return ready;
+}
+
+static bool binaryDecode(void* decoder, uint8_t* out) {
+    binaryBenchDecoder* d = (binaryBenchDecoder*)decoder;
+    return DecodeInto(d->decoder, out);
+}
+
+static void binaryFreeDecoder(void* decoder) {
+    binaryBenchDecoder* d = (binaryBenchDecoder*)decoder;
+    FreeDecoder(d->decoder);
+    free(d);
+}
+
+static const decoderStats* binaryStats(void* decoder) {
+    return &((binaryBenchDecoder*)decoder)->decoder->matrix.stats;
+}
+
+static void binaryDestroy(void* state) {
+    binaryState* s = (binaryState*)state;
+    freeSymbolMatrix(s->intermediate);
+    free(s->srcs);
+    free(s->indices);
+    free(s->codec);
+    free(s);
+}
+
+int main(int argc, char** argv) {
+    benchCodec codec = {"binary", 2048, binaryCreate, binaryEncode, binaryNewDecoder, binaryAdd, binaryDecode, binaryFreeDecoder, binaryDestroy, binaryStats};
+    benchCodec libc = {"binary-libc", 2048, binaryCreateLibc, binaryEncode, binaryNewDecoder, binaryAdd, binaryDecode, binaryFreeDecoder, binaryDestroy, binaryStats};
+    int status = benchMain(&codec, argc, argv);
+    return status != 0 ? status : benchMain(&libc, argc, argv);
+}
@@ -0,0 +1,83 @@
+#include <stdlib.h>
+#include <math.h>
+#include "bench.h"
+#include "luby.h"
+
+// LT 코덱: robust soliton 분포 (m = sqrt(k), delta = 0.05)
+typedef struct {
+    Codec* codec;
+    LTEncoder* encoder;
+    size_t length;
+} lubyState;
+
+typedef struct {
+    Decoder* decoder;
+    size_t symbolSize;
+} lubyDecoder;
+
+static void* lubyCreate(int k, const uint8_t* message, size_t length) {
+    lubyState* s = (lubyState*)malloc(sizeof(lubyState));
+    int m = (int)sqrt((double)k);
+    const degreeDist* degrees = acquireRobustSoliton(k, m > 0 ? m : 1, 0.05);
+    s->codec = NewLubyCodecShared(k, 7, degrees);
+    releaseDegreeDist(degrees);
+    s->encoder = NewLTEncoder(s->codec, (uint8_t*)message, length);
+    s->length = length;
+    return s;
+}
+
+static void lubyEncode(void* state, const int64_t* ids, int n, uint8_t* out) {
+    lubyState* s = (lubyState*)state;
+    EncodeLTBlocksAt(s->encoder, ids, n, out, NULL);
+}
+
+static void* lubyNewDecoder(void* state, uint8_t* out) {
+    lubyState* s = (lubyState*)state;
+    lubyDecoder* d = (lubyDecoder*)malloc(sizeof(lubyDecoder));
+    d->decoder = s->codec->NewDecoderInto(s->codec, (int)s->length, out);
+    d->symbolSize = LTEncoderBlockLength(s->encoder);
+    return d;
+}
+
+static bool lubyAdd(void* decoder, const int64_t* ids, const uint8_t* symbols, int n) {
+    lubyDecoder* d = (lubyDecoder*)decoder;
+    LTBlock* blocks = (LTBlock*)malloc(n * sizeof(LTBlock));
+    for (int i = 0; i < n; i++) {
+        blocks[i].blockCode = ids[i];
+        blocks[i].data = (uint8_t*)symbols + (size_t)i * d->symbolSize;
+        blocks[i].length = d->symbolSize;
+    }
+    bool ready = d->decoder->AddBlocks(d->decoder, blocks, n);
+    free(blocks);
+    return ready;
+}
+
+// 디코더가 호출자 버퍼에 바로 풀기 때문에 Decode는 그 버퍼를 돌려줍니다.
+static bool lubyDecode(void* decoder, uint8_t* out) {
+    lubyDecoder* d = (lubyDecoder*)decoder;
+    int size;
+    return d->decoder->Decode(d->decoder, &size) == out;
+}
+
+static void lubyFreeDecoder(void* decoder) {
+    lubyDecoder* d = (lubyDecoder*)decoder;
+    d->decoder->Free(d->decoder);
+    free(d);
+}
+
+static const decoderStats* lubyStats(void* decoder) {
+    lubyDecoder* d = (lubyDecoder*)decoder;
+    return d->decoder->Stats(d->decoder);
+}
+
+static void lubyDestroy(void* state) {
+    lubyState* s = (lubyState*)state;
+    FreeLTEncoder(s->encoder);
+    s->codec->Free(s->codec);
+    free(s);
+}
+
+int main(int argc, char** argv) {
+    benchCodec codec = {"luby", 0, lubyCreate, lubyEncode, lubyNewDecoder, lubyAdd, lubyDecode, lubyFreeDecoder, lubyDestroy, lubyStats};
+    return benchMain(&codec, argc, argv);
+}
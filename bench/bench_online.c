@@ -0,0 +1,59 @@
+#include <stdlib.h>
+#include "bench.h"
+#include "online.h"
+
+// Online 코덱 (epsilon = 0.01, quality = 3)
+typedef struct {
+    online_codec* codec;
+    const uint8_t* message;     // 인코더가 원본 블록을 바로 읽음 (runCase가 소유)
+    symbolMatrix* aux;
+    int length;
+} onlineState;
+
+static void* onlineCreate(int k, const uint8_t* message, size_t length) {
+    onlineState* s = (onlineState*)malloc(sizeof(onlineState));
+    s->codec = create_online_codec(k, 0.01, 3, 7);
+    s->message = message;
+    s->aux = generate_intermediate_blocks(s->codec, message, length);
+    s->length = (int)length;
+    return s;
+}
+
+static void onlineEncode(void* state, const int64_t* ids, int n, uint8_t* out) {
+    onlineState* s = (onlineState*)state;
+    encode_online_blocks(s->codec, s->message, s->length, s->aux, ids, n, out);
+}
+
+static void* onlineNewDecoder(void* state, uint8_t* out) {
+    (void)out;
+    onlineState* s = (onlineState*)state;
+    return new_online_decoder(s->codec, s->length);
+}
+
+static bool onlineAdd(void* decoder, const int64_t* ids, const uint8_t* symbols, int n) {
+    return online_add_blocks((online_decoder*)decoder, ids, symbols, n);
+}
+
+static bool onlineDecode(void* decoder, uint8_t* out) {
+    return online_decode_into((online_decoder*)decoder, out);
+}
+
+static void onlineFreeDecoder(void* decoder) {
+    destroy_online_decoder((online_decoder*)decoder);
+}
+
+static const decoderStats* onlineStats(void* decoder) {
+    return &((online_decoder*)decoder)->matrix->stats;
+}
+
+static void onlineDestroy(void* state) {
+    onlineState* s = (onlineState*)state;
+    freeSymbolMatrix(s->aux);
+    destroy_online_codec(s->codec);
+    free(s);
+}
+
+int main(int argc, char** argv) {
+    benchCodec codec = {"online", 0, onlineCreate, onlineEncode, onlineNewDecoder, onlineAdd, onlineDecode, onlineFreeDecoder, onlineDestroy, onlineStats};
+    return benchMain(&codec, argc, argv);
+}
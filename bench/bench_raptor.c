@@ -0,0 +1,76 @@
+#include <stdlib.h>
+#include "bench.h"
+#include "fountain.h"
+
+// Raptor (R10) 코덱. ESI는 16비트라 기호 ID를 uint16으로 넘깁니다.
+typedef struct {
+    RaptorCodec* codec;
+    RaptorEncoder* encoder;
+    int length;
+} raptorState;
+
+typedef struct {
+    void* decoder;
+    int symbolSize;
+} raptorDecoder;
+
+static void* raptorCreate(int k, const uint8_t* message, size_t length) {
+    raptorState* s = (raptorState*)malloc(sizeof(raptorState));
+    s->codec = NewRaptorCodec(k, 4);
+    s->encoder = NewRaptorEncoder(s->codec, message, (int)length);
+    s->length = (int)length;
+    return s;
+}
+
+static void raptorEncode(void* state, const int64_t* ids, int n, uint8_t* out) {
+    raptorState* s = (raptorState*)state;
+    EncodeRaptorSymbolsAt(s->encoder, ids, n, out, NULL);
+}
+
+static void* raptorNewDecoder(void* state, uint8_t* out) {
+    (void)out;
+    raptorState* s = (raptorState*)state;
+    raptorDecoder* d = (raptorDecoder*)malloc(sizeof(raptorDecoder));
+    d->decoder = new_decoder(s->codec, s->length);
+    d->symbolSize = RaptorEncoderSymbolSize(s->encoder);
+    return d;
+}
+
+static bool raptorAdd(void* decoder, const int64_t* ids, const uint8_t* symbols, int n) {
+    raptorDecoder* d = (raptorDecoder*)decoder;
+    uint16_t* esis = (uint16_t*)malloc(n * sizeof(uint16_t));
+    for (int i = 0; i < n; i++) {
+        esis[i] = (uint16_t)ids[i];
+    }
+    bool ready = add_blocks(d->decoder, esis, symbols, n);
+    free(esis);
+    return ready;
+}
+
+static bool raptorDecode(void* decoder, uint8_t* out) {
+    raptorDecoder* d = (raptorDecoder*)decoder;
+    return decode_into(d->decoder, out);
+}
+
+static void raptorFreeDecoder(void* decoder) {
+    raptorDecoder* d = (raptorDecoder*)decoder;
+    destroy_raptor_decoder(d->decoder);
+    free(d);
+}
+
+static const decoderStats* raptorStats(void* decoder) {
+    raptorDecoder* d = (raptorDecoder*)decoder;
+    return &((raptor_decoder*)d->decoder)->matrix->stats;
+}
+
+static void raptorDestroy(void* state) {
+    raptorState* s = (raptorState*)state;
+    FreeRaptorEncoder(s->encoder);
+    free(s->codec);
+    free(s);
+}
+
+int main(int argc, char** argv) {
+    benchCodec codec = {"raptor", MAX_SOURCE_SYMBOLS, raptorCreate, raptorEncode, raptorNewDecoder, raptorAdd, raptorDecode, raptorFreeDecoder, raptorDestroy, raptorStats};
+    return benchMain(&codec, argc, argv);
+}
@@ -0,0 +1,79 @@
+#include <stdlib.h>
+#include "bench.h"
+#include "raptorq.h"
+
+// RaptorQ 방식 코덱. 중간 기호를 한 번 만들어 두고 기호마다 raptorq_encode를 부릅니다.
+typedef struct {
+    RaptorQCodec* codec;
+    symbolMatrix* intermediate;
+    int length;
+} raptorqState;
+
+typedef struct {
+    void* decoder;
+    int symbolSize;
+} raptorqDecoder;
+
+static void* raptorqCreate(int k, const uint8_t* message, size_t length) {
+    raptorqState* s = (raptorqState*)malloc(sizeof(raptorqState));
+    s->codec = create_raptorq_codec(k, 4);
+    s->intermediate = raptorq_generate_intermediate_blocks(&s->codec->params, message, (int)length, 4);
+    s->length = (int)length;
+    return s;
+}
+
+static void raptorqEncode(void* state, const int64_t* ids, int n, uint8_t* out) {
+    raptorqState* s = (raptorqState*)state;
+    int symbolSize = s->intermediate->symbolSize;
+    for (int i = 0; i < n; i++) {
+        raptorq_encode(&s->codec->params, (uint32_t)ids[i], s->intermediate, out + (size_t)i * symbolSize);
+    }
+}
+
+static void* raptorqNewDecoder(void* state, uint8_t* out) {
+    (void)out;
+    raptorqState* s = (raptorqState*)state;
+    raptorqDecoder* d = (raptorqDecoder*)malloc(sizeof(raptorqDecoder));
+    d->decoder = raptorq_new_decoder(s->codec, s->length);
+    d->symbolSize = s->intermediate->symbolSize;
+    return d;
+}
+
+static bool raptorqAdd(void* decoder, const int64_t* ids, const uint8_t* symbols, int n) {
+    raptorqDecoder* d = (raptorqDecoder*)decoder;
+    uint32_t* esis = (uint32_t*)malloc(n * sizeof(uint32_t));
+    for (int i = 0; i < n; i++) {
+        esis[i] = (uint32_t)ids[i];
+    }
+    bool ready = raptorq_add_blocks(d->decoder, esis, symbols, n);
+    free(esis);
+    return ready;
+}
+
+static bool raptorqDecode(void* decoder, uint8_t* out) {
+    raptorqDecoder* d = (raptorqDecoder*)decoder;
+    return raptorq_decode_into(d->decoder, out);
+}
+
+static void raptorqFreeDecoder(void* decoder) {
+    raptorqDecoder* d = (raptorqDecoder*)decoder;
+    raptorq_destroy_decoder(d->decoder);
+    free(d);
+}
+
+static const decoderStats* raptorqStats(void* decoder) {
+    raptorqDecoder* d = (raptorqDecoder*)decoder;
+    return &((raptorq_decoder*)d->decoder)->matrix->stats;
+}
+
+static void raptorqDestroy(void* state) {
+    raptorqState* s = (raptorqState*)state;
+    freeSymbolMatrix(s->intermediate);
+    destroy_raptorq_codec(s->codec);
+    free(s);
+}
+
+int main(int argc, char** argv) {
+    benchCodec codec = {"raptorq", RAPTORQ_MAX_SOURCE_SYMBOLS, raptorqCreate, raptorqEncode, raptorqNewDecoder, raptorqAdd, raptorqDecode, raptorqFreeDecoder, raptorqDestroy, raptorqStats};
+    return benchMain(&codec, argc, argv);
+}
@@ -0,0 +1,81 @@
+#include <stdlib.h>
+#include "bench.h"
+#include "ru10.h"
+#include "xor.h"
+
+// RU10 코덱. 카운터 PRNG("ru10")와 MT19937("ru10-mt")을 차례로 잽니다.
+typedef struct {
+    ru10_codec* codec;
+    symbolMatrix* intermediate;
+    int* indices;
+    const uint8_t** srcs;
+    int length;
+} ru10State;
+
+static void* createState(ru10_codec* codec, const uint8_t* message, size_t length) {
+    ru10State* s = (ru10State*)malloc(sizeof(ru10State));
+    s->codec = codec;
+    s->intermediate = generate_intermediate_blocks(s->codec, message, length);
+    s->indices = (int*)malloc(s->intermediate->count * sizeof(int));
+    s->srcs = (const uint8_t**)malloc(s->intermediate->count * sizeof(uint8_t*));
+    s->length = (int)length;
+    return s;
+}
+
+static void* ru10Create(int k, const uint8_t* message, size_t length) {
+    return createState(create_ru10_codec_seeded(k, 4, 7), message, length);
+}
+
+static void* ru10CreateMT(int k, const uint8_t* message, size_t length) {
+    return createState(create_ru10_codec_mt19937(k, 4, 7), message, length);
+}
+
+static void ru10Encode(void* state, const int64_t* ids, int n, uint8_t* out) {
+    ru10State* s = (ru10State*)state;
+    const symbolMatrix* c = s->intermediate;
+    for (int i = 0; i < n; i++) {
+        int count = pick_indices(s->codec, ids[i], s->indices, c->count);
+        for (int j = 0; j < count; j++) {
+            s->srcs[j] = symbolAt(c, s->indices[j]);
+        }
+        xorBytesGather(out + (size_t)i * c->symbolSize, s->srcs, count, c->symbolSize);
+    }
+}
+
+static void* ru10NewDecoder(void* state, uint8_t* out) {
+    (void)out;
+    ru10State* s = (ru10State*)state;
+    return new_ru10_decoder(s->codec, s->length);
+}
+
+static bool ru10Add(void* decoder, const int64_t* ids, const uint8_t* symbols, int n) {
+    return ru10_add_blocks((ru10_decoder*)decoder, ids, symbols, n);
+}
+
+static bool ru10Decode(void* decoder, uint8_t* out) {
+    return ru10_decode_into((ru10_decoder*)decoder, out);
+}
+
+static void ru10FreeDecoder(void* decoder) {
+    destroy_ru10_decoder((ru10_decoder*)decoder);
+}
+
+static const decoderStats* ru10Stats(void* decoder) {
+    return &((ru10_decoder*)decoder)->matrix->stats;
+}
+
+static void ru10Destroy(void* state) {
+    ru10State* s = (ru10State*)state;
+    freeSymbolMatrix(s->intermediate);
+    free(s->srcs);
+    free(s->indices);
+    destroy_ru10_codec(s->codec);
+    free(s);
+}
+
+int main(int argc, char** argv) {
+    benchCodec codec = {"ru10", 0, ru10Create, ru10Encode, ru10NewDecoder, ru10Add, ru10Decode, ru10FreeDecoder, ru10Destroy, ru10Stats};
+    benchCodec mt = {"ru10-mt", 0, ru10CreateMT, ru10Encode, ru10NewDecoder, ru10Add, ru10Decode, ru10FreeDecoder, ru10Destroy, ru10Stats};
+    int status = benchMain(&codec, argc, argv);
+    return status != 0 ? status : benchMain(&mt, argc, argv);
+}
@@ -0,0 +1,18 @@
+#ifndef ALIAS_H
+#define ALIAS_H
+
+// aliasTable 구조체: Walker/Vose 별칭 테이블. n개의 항목 중 하나를 확률에 따라
+// O(1)에 뽑습니다. 칸 i를 고른 뒤 prob[i]의 확률로 i를, 아니면 alias[i]를 고르고
+// 칸 번호 + 1 (차수)을 돌려줍니다.
+typedef struct {
+    int n;          // 항목 수
+    double* prob;   // 각 칸에 남는 자기 항목의 확률
+    int* alias;     // 각 칸의 나머지 확률이 가리키는 항목
+} aliasTable;
+
+// 함수 선언
+aliasTable* newAliasTable(const double* cdf, int size);
+void freeAliasTable(aliasTable* t);
+int aliasSample(const aliasTable* t, double u);
+
+#endif // ALIAS_H
@@ -0,0 +1,35 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct arenaSlab arenaSlab;
+
+// arena 구조체: 코덱/디코더 하나가 쓰는 메모리를 큰 슬랩 단위로 잡아 두고
+// 잘라서 나눠 줍니다. 개별 해제는 없고 arenaFree로 한 번에 돌려줍니다.
+// 고정 크기 기호 버퍼는 arenaRelease로 반납하면 다음 arenaSymbol이 재사용합니다.
+typedef struct {
+    arenaSlab* head;     // 현재 슬랩 (이전 슬랩들은 연결 목록)
+    size_t slabSize;     // 슬랩 하나의 바이트 수
+    size_t symbolSize;   // arenaSymbol이 돌려주는 버퍼의 바이트 수
+    void* freeSymbols;   // 반납된 기호 버퍼 목록
+    size_t reserved;     // malloc으로 잡은 전체 바이트 수
+} arena;
+
+// 되감기 지점. 임시 버퍼를 쓴 뒤 arenaRewind로 한 번에 돌려줍니다.
+typedef struct {
+    arenaSlab* slab;
+    size_t used;
+} arenaMark;
+
+// 함수 선언
+void arenaInit(arena* a, size_t symbolSize, size_t slabSize);
+void* arenaAlloc(arena* a, size_t size);
+uint8_t* arenaSymbol(arena* a);
+void arenaRelease(arena* a, uint8_t* symbol);
+arenaMark arenaSave(arena* a);
+void arenaRewind(arena* a, arenaMark mark);
+void arenaFree(arena* a);
+
+#endif // ARENA_H
@@ -6,31 +6,40 @@
 
 #include "block.h"
 #include "luby.h"
+#include "prng.h"
 
 
 // BinaryCodec structure
 typedef struct {
     int numSourceBlocks;
+    prngMode prng;
+    uint64_t seed;    // Used by PRNG_COUNTER
 } binaryCodec;
 
 // BinaryDecoder structure
 typedef struct {
     binaryCodec codec;
     int messageLength;
+    int symbolSize;   // Bytes per source block
+    int* batch;       // Index sets of the batch being added, back to back
+    int batchCap;
     sparseMatrix matrix;
 } binaryDecoder;
 
 // Function declarations
 binaryCodec* NewBinaryCodec(int numSourceBlocks);
+binaryCodec* NewBinaryCodecSeeded(int numSourceBlocks, uint64_t seed);
+int PickIndicesInto(binaryCodec* codec, int64_t codeBlockIndex, int* indices);
 int* PickIndices(binaryCodec* codec, int64_t codeBlockIndex, int* outLength);
-block* GenerateIntermediateBlocks(binaryCodec* codec, uint8_t* message, int messageLength, int numBlocks);
+symbolMatrix* GenerateIntermediateBlocks(binaryCodec* codec, uint8_t* message, int messageLength, int numBlocks);
 binaryDecoder* NewDecoder(binaryCodec* codec, int messageLength);
+void FreeDecoder(binaryDecoder* decoder);
 bool AddBlocks(binaryDecoder* decoder, LTBlock* blocks, int numBlocks);
 uint8_t* Decode(binaryDecoder* decoder, int* outLength);
+bool DecodeInto(binaryDecoder* decoder, uint8_t* out);
 
 // Helper functions (need to be implemented)
 void intermediateSymbols(int k, uint32_t* l);
 void tripleGenerator(int k, uint16_t x, uint32_t* d, uint32_t* a, uint32_t* b);
-block* equalizeBlockLengths(int** longBlocks, int** shortBlocks, int numLong, int numShort, int longBlockSize, int shortBlockSize);
 
 #endif // BINARY_H
\ No newline at end of file
@@ -3,6 +3,9 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "arena.h"
+#include "symbols.h"
+#include "stats.h"
 
 // block 구조체: 데이터 블록을 나타냅니다.
 typedef struct {
@@ -14,8 +17,14 @@ typedef struct {
 // sparseMatrix 구조체: 희소 행렬을 나타냅니다.
 typedef struct {
     int** coeff;   // 행렬의 계수
+    int* coeffLen; // 각 행의 계수 수
     block* v;      // 행렬의 값 (블록 배열)
     int numRows;   // 행렬의 행 수
+    int rank;      // 피벗이 정해진 행의 수
+    int solved;    // 하나의 원본 블록으로 풀린 행의 수
+    arena mem;     // 행 인덱스와 값 블록을 담는 아레나
+    int* scratch[2]; // addEquation이 진행 중인 행에 번갈아 쓰는 버퍼
+    decoderStats stats; // 계측 카운터 (peeled는 차수 1로 들어온 행, eliminated는 나머지 피벗)
 } sparseMatrix;
 
 // 함수 선언
@@ -23,11 +32,12 @@ block* newBlock(int len);
 int blockLength(block* b);
 bool blockEmpty(block* b);
 void blockXor(block* b, block* a);
-int** PartitionBytes(uint8_t* in, int inLen, int p, block** longBlocks, int* numLong, block** shortBlocks, int* numShort);
+void initSparseMatrix(sparseMatrix* m, int numRows, int symbolSize);
+void freeSparseMatrix(sparseMatrix* m);
 void addEquation(sparseMatrix* m, int* components, int numComponents, block b);
 int* xorRow(sparseMatrix *m, int s, int *indices, size_t indices_len, block *b, size_t *new_indices_len);
 bool determined(sparseMatrix* m);
-void Reduce(sparseMatrix* m);
-uint8_t* Reconstruct(sparseMatrix* m, int totalLength, int lenLong, int lenShort, int numLong, int numShort);
+double decodeProgress(sparseMatrix* m);
+void Reduce(sparseMatrix* m, symbolMatrix* out);
 
 #endif // BLOCK_H
\ No newline at end of file
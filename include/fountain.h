@@ -4,10 +4,30 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "raptor.h"
+#include "luby.h"
+#include "pool.h"
+
+// RFC 5053의 인코딩 기호 ID(ESI)는 16비트입니다.
+#define RAPTOR_MAX_ESI 65535
+
+// RaptorEncoder 구조체: 메시지의 중간 기호를 들고 있다가 요청할 때마다 다음
+// 기호를 만들어 주는 인코더
+typedef struct {
+    const RaptorCodec* codec;   // 소유하지 않음
+    symbolMatrix* intermediate; // 메시지의 중간 기호 L개
+    int64_t nextId;             // NextRaptorSymbols가 다음에 낼 ID
+} RaptorEncoder;
 
 // 함수 선언
 RaptorCodec* NewRaptorCodec(int symbols, int alignment);
-LTBlock* EncodeLTBlocks(uint8_t* message, int messageLen, int64_t* ids, int numIds, RaptorCodec* codec);
+LTBlock* EncodeRaptorBlocks(const uint8_t* message, int messageLen, int64_t* ids, int numIds, RaptorCodec* codec);
+int EncodeRaptorBlocksInto(const uint8_t* message, int messageLen, const int64_t* ids, int numIds, RaptorCodec* codec, uint8_t* output, threadPool* pool);
+RaptorEncoder* NewRaptorEncoder(const RaptorCodec* codec, const uint8_t* message, int messageLen);
+int RaptorEncoderSymbolSize(const RaptorEncoder* encoder);
+int NextRaptorSymbols(RaptorEncoder* encoder, int n, int64_t* ids, uint8_t* output, threadPool* pool);
+bool EncodeRaptorSymbolsAt(RaptorEncoder* encoder, const int64_t* ids, int numIds, uint8_t* output, threadPool* pool);
+void FreeRaptorEncoder(RaptorEncoder* encoder);
 uint8_t* Decode(RaptorCodec* codec, LTBlock* encodedSymbols, int numSymbols, int messageSize, int* decodedSymbolIndex, int* outSize, uint8_t hash[32]);
+bool DecodeInto(RaptorCodec* codec, LTBlock* encodedSymbols, int numSymbols, int messageSize, uint8_t* output, int* decodedSymbolIndex);
 
 #endif // FOUNTAIN_H
\ No newline at end of file
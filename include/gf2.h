@@ -0,0 +1,30 @@
+#ifndef GF2_H
+#define GF2_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// gf2Matrix 구조체: GF(2) 계수 행렬. 한 행은 uint64 워드에 비트 단위로 저장되며
+// 모든 행은 하나의 연속된 메모리 영역에 놓입니다. rows는 그 영역을 가리키는
+// 포인터 배열이라 행 교환은 포인터 교환으로 끝납니다.
+typedef struct {
+    uint64_t** rows;  // 각 행의 시작 위치
+    uint64_t* words;  // 모든 행의 비트
+    int numRows;      // 행의 수
+    int numCols;      // 열의 수
+    int stride;       // 한 행의 워드 수
+} gf2Matrix;
+
+// 함수 선언
+gf2Matrix* newGF2Matrix(int numRows, int numCols);
+void freeGF2Matrix(gf2Matrix* m);
+void gf2Set(gf2Matrix* m, int row, int col);
+bool gf2Get(const gf2Matrix* m, int row, int col);
+void gf2SwapRows(gf2Matrix* m, int a, int b);
+void gf2XorRows(gf2Matrix* m, int dst, int src, int fromCol);
+void gf2XorRowInto(gf2Matrix* dst, int dstRow, const gf2Matrix* src, int srcRow);
+int gf2RowWeight(const gf2Matrix* m, int row);
+int gf2NextSet(const gf2Matrix* m, int row, int fromCol);
+int gf2FindPivot(const gf2Matrix* m, int col, int fromRow);
+
+#endif // GF2_H
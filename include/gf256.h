@@ -0,0 +1,41 @@
+#ifndef GF256_H
+#define GF256_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// GF(256) 연산. RFC 6330 5.7과 같은 기약 다항식 x^8 + x^4 + x^3 + x^2 + 1 (0x11D)과
+// 생성원 alpha = 2를 씁니다. 덧셈은 XOR이라 xor.h의 커널을 그대로 씁니다.
+// 곱셈-누산 커널은 곱할 상수마다 하위/상위 니블 표 두 개(16바이트씩)를 두고,
+// CPU가 지원하면 PSHUFB(SSSE3, AVX2)로 한 번에 16/32바이트씩 표를 찾습니다.
+
+extern const uint8_t gf256ExpTable[510]; // alpha^i (i < 510, 두 바퀴)
+extern const uint8_t gf256LogTable[256]; // log_alpha(x) (x = 0은 정의되지 않음)
+
+// a * b
+static inline uint8_t gf256Mul(uint8_t a, uint8_t b) {
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    return gf256ExpTable[gf256LogTable[a] + gf256LogTable[b]];
+}
+
+// a^-1 (a != 0)
+static inline uint8_t gf256Inv(uint8_t a) {
+    return gf256ExpTable[255 - gf256LogTable[a]];
+}
+
+// alpha^i (i >= 0)
+static inline uint8_t gf256Exp(int i) {
+    return gf256ExpTable[i % 255];
+}
+
+// 함수 선언
+// dst ^= c * src
+void gf256MulAdd(uint8_t* dst, const uint8_t* src, uint8_t c, size_t length);
+// dst = c * dst
+void gf256Scale(uint8_t* dst, uint8_t c, size_t length);
+// 선택된 커널의 이름 ("avx2", "ssse3" 또는 "table")
+const char* gf256KernelName(void);
+
+#endif // GF256_H
@@ -0,0 +1,41 @@
+#ifndef INACTIVATION_H
+#define INACTIVATION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "arena.h"
+#include "symbols.h"
+#include "stats.h"
+
+// inactivation_decoder 구조체: L개의 중간 기호에 대한 GF(2) 방정식 모음.
+// 풀이는 RFC 5053의 방식을 따릅니다. 먼저 차수 1인 행을 벗겨내고(peeling),
+// 막히면 일부 열을 비활성(inactive)으로 옮긴 뒤, 남은 작은 밀집 시스템을
+// 비트 패킹 소거로 풀고 역대입합니다. RaptorQ(RFC 6330)처럼 처음부터 비활성인
+// 열과 GF(256) 계수의 밀집 행을 둘 수 있고, 밀집 행은 peeling에 참여하지 않고
+// 마지막 밀집 시스템에만 들어갑니다. 이때 밀집 시스템은 GF(256)에서 풉니다.
+typedef struct {
+    int num_cols;          // 중간 기호의 수 (L)
+    int symbol_size;       // 기호 하나의 바이트 수
+    int num_rows;          // 추가된 방정식의 수
+    int cap_rows;
+    int** row_indices;     // 각 방정식에 포함된 열
+    int* row_degree;       // 각 방정식의 열 수
+    uint8_t** row_values;  // 각 방정식의 값 (제약 방정식은 NULL = 0)
+    int num_permanent;     // 처음부터 비활성인 마지막 열의 수 (풀이 전에 호출자가 정함)
+    int num_dense;         // GF(256) 밀집 행의 수
+    int cap_dense;
+    uint8_t** dense_coeffs; // 각 밀집 행의 계수 (num_cols 바이트)
+    uint8_t** dense_values; // 각 밀집 행의 값 (NULL = 0)
+    arena mem;             // 방정식의 인덱스와 값을 담는 아레나
+    decoderStats stats;    // 계측 카운터. peeled, eliminated, inactivated, rank는 마지막 풀이의 값
+} inactivation_decoder;
+
+// 함수 선언
+inactivation_decoder* new_inactivation_decoder(int num_cols, int symbol_size);
+void destroy_inactivation_decoder(inactivation_decoder* dec);
+void inactivation_add_row(inactivation_decoder* dec, const int* indices, int num_indices, const uint8_t* value);
+void inactivation_add_dense_row(inactivation_decoder* dec, const uint8_t* coeffs, const uint8_t* value);
+void inactivation_add_constraints(inactivation_decoder* dec, int k, int s, int h);
+bool inactivation_solve(inactivation_decoder* dec, symbolMatrix* out);
+
+#endif // INACTIVATION_H
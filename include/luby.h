@@ -4,6 +4,10 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include "symbols.h"
+#include "pool.h"
+#include "soliton.h"
+#include "stats.h"
 
 // LTBlock structure: represents a block created using the LT transform.
 typedef struct {
@@ -15,9 +19,11 @@ typedef struct {
 // Codec interface (in C represented as a struct with function pointers)
 typedef struct Codec {
     int (*SourceBlocks)(struct Codec*);
-    void (*GenerateIntermediateBlocks)(struct Codec*, uint8_t*, size_t, int, uint8_t***, int*);
+    symbolMatrix* (*GenerateIntermediateBlocks)(struct Codec*, uint8_t*, size_t, int);
     int* (*PickIndices)(struct Codec*, int64_t, int*);
+    int (*PickIndicesInto)(struct Codec*, int64_t, int*); // Into scratch of SourceBlocks ints, returns the count
     struct Decoder* (*NewDecoder)(struct Codec*, int);
+    struct Decoder* (*NewDecoderInto)(struct Codec*, int, uint8_t*); // Decodes in place into a caller buffer
     void (*Free)(struct Codec*); // Free function to deallocate memory
 } Codec;
 
@@ -26,10 +32,26 @@ typedef struct Decoder {
     bool (*AddBlocks)(struct Decoder*, LTBlock*, int);
     uint8_t* (*Decode)(struct Decoder*, int*);
     void (*Free)(struct Decoder*); // Free function to deallocate memory
+    const decoderStats* (*Stats)(struct Decoder*); // Instrumentation counters (see stats.h)
 } Decoder;
 
+// LTEncoder structure: a rateless encoder that keeps a message's intermediate
+// blocks resident and hands out blocks on demand.
+typedef struct {
+    Codec* codec;               // Codec used to pick indices (not owned)
+    symbolMatrix* intermediate; // Intermediate blocks of the message
+    int64_t nextID;             // ID of the next block NextLTBlocks produces
+} LTEncoder;
+
 // Function prototypes
 Codec* NewLubyCodec(int sourceBlocks, unsigned int seed, double* degreeCDF, int degreeCDFLength);
+Codec* NewLubyCodecShared(int sourceBlocks, unsigned int seed, const degreeDist* degrees);
 LTBlock* EncodeLTBlocks(Codec* codec, uint8_t* message, size_t messageLength, int64_t* encodedBlockIDs, int numIDs, int* outSize);
+size_t EncodeLTBlocksInto(Codec* codec, uint8_t* message, size_t messageLength, const int64_t* encodedBlockIDs, int numIDs, uint8_t* output, threadPool* pool);
+LTEncoder* NewLTEncoder(Codec* codec, uint8_t* message, size_t messageLength);
+size_t LTEncoderBlockLength(const LTEncoder* encoder);
+int64_t NextLTBlocks(LTEncoder* encoder, int n, uint8_t* output, threadPool* pool);
+void EncodeLTBlocksAt(LTEncoder* encoder, const int64_t* encodedBlockIDs, int numIDs, uint8_t* output, threadPool* pool);
+void FreeLTEncoder(LTEncoder* encoder);
 
 #endif // LUBY_H
@@ -0,0 +1,28 @@
+#ifndef MAPFILE_H
+#define MAPFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "object.h"
+#include "pool.h"
+
+// mappedFile 구조체: mmap으로 메모리에 올린 파일. 읽기 전용 입력이거나
+// 미리 크기를 잡아 둔 쓰기용 출력입니다.
+typedef struct {
+    uint8_t* data;    // 매핑 시작 (빈 파일이면 NULL)
+    uint64_t length;  // 파일 길이
+    int fd;
+    bool writable;
+    char* path;       // 출력 파일의 최종 경로 (입력이면 NULL)
+    char* tempPath;   // 디코딩 중에 쓰는 임시 파일 (입력이면 NULL)
+} mappedFile;
+
+// 함수 선언
+mappedFile* MapInputFile(const char* path);
+mappedFile* CreateOutputFile(const char* path, uint64_t length);
+bool CloseMappedFile(mappedFile* file);
+void DiscardOutputFile(mappedFile* file);
+bool EncodeRaptorFile(const mappedFile* input, const RaptorObjectInfo* oti, const uint16_t* esis, int numEsis, uint8_t* output, threadPool* pool);
+bool DecodeRaptorFile(const char* path, const RaptorObjectInfo* oti, const ObjectSymbol* symbols, int numSymbols, threadPool* pool);
+
+#endif // MAPFILE_H
@@ -0,0 +1,44 @@
+#ifndef MERSENNE_H
+#define MERSENNE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MT_N 624
+#define MT_M 397
+#define MT64_N 312
+#define MT64_M 156
+
+// 32-bit Mersenne Twister MT19937
+typedef struct {
+    uint32_t mt[624];
+    int index;
+    bool initialized;
+} MersenneTwister;
+
+// 64-bit Mersenne Twister MT19937-64
+typedef struct {
+    uint64_t mt[312];
+    int index;
+    bool initialized;
+} MersenneTwister64;
+
+// Function prototypes
+void initializeMT(MersenneTwister* t, uint32_t seed);
+void generateUntemperedMT(MersenneTwister* t);
+uint32_t uint32(MersenneTwister* t);
+int64_t int63(MersenneTwister* t);
+void seedMT(MersenneTwister* t, int64_t seed);
+MersenneTwister newMersenneTwister(int64_t seed);
+void drawMT(int64_t seed, uint32_t* out, int n);
+
+void initializeMT64(MersenneTwister64* t, uint64_t seed);
+void generateUntemperedMT64(MersenneTwister64* t);
+uint64_t uint64(MersenneTwister64* t);
+int64_t int63_64(MersenneTwister64* t);
+void seedMT64(MersenneTwister64* t, int64_t seed);
+MersenneTwister64 newMersenneTwister64(int64_t seed);
+void seedSliceMT64(MersenneTwister64* t, const uint64_t* seed, int seedLength);
+void drawMT64(int64_t seed, uint64_t* out, int n);
+
+#endif // MERSENNE_H
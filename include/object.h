@@ -0,0 +1,56 @@
+#ifndef OBJECT_H
+#define OBJECT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "raptor.h"
+#include "pool.h"
+
+// RaptorObjectInfo 구조체: 한 원본 블록(최대 MAX_SOURCE_SYMBOLS 기호)보다 큰
+// 객체를 RFC 5053 5.3.1.2의 방식으로 Z개의 원본 블록과 블록마다 N개의 하위
+// 블록으로 나눈 결과. 원본 블록은 서로 독립적으로 인코딩/디코딩됩니다.
+typedef struct {
+    uint64_t F;    // 객체(전송) 길이
+    int Al;        // 기호 정렬 단위
+    int T;         // 기호 크기 (Al의 배수)
+    int Z;         // 원본 블록 수
+    int N;         // 원본 블록당 하위 블록 수
+    int KL, KS;    // 긴/짧은 원본 블록의 기호 수
+    int ZL, ZS;    // 긴/짧은 원본 블록 수 (긴 블록이 앞)
+    int TL, TS;    // 긴/짧은 하위 기호 크기 (Al 단위)
+    int NL, NS;    // 긴/짧은 하위 블록 수 (긴 블록이 앞)
+} RaptorObjectInfo;
+
+// 객체 단위로 주고받는 인코딩 기호 하나
+typedef struct {
+    int sbn;             // 원본 블록 번호
+    uint16_t esi;        // 블록 안의 기호 ID
+    const uint8_t* data; // T 바이트
+} ObjectSymbol;
+
+// RaptorBlockDecoder 구조체: 원본 블록 하나를 기호가 오는 대로 받아 푸는 디코더.
+// 받는 쪽은 기호를 sbn별로 나눠 블록마다 디코더 하나에 넣고, 블록이 풀리면
+// 디코더를 해제합니다. 그러면 객체 전체가 아니라 아직 풀리지 않은 블록의 기호만
+// 메모리에 남습니다 (DecodeRaptorObject는 모든 기호를 한꺼번에 받습니다).
+typedef struct {
+    const RaptorObjectInfo* oti; // 소유하지 않음
+    int sbn;                     // 원본 블록 번호
+    RaptorCodec codec;           // 이 블록의 기호 수에 대한 코덱
+    void** subDecoders;          // 하위 블록마다 R10 디코더 (풀린 것은 NULL)
+    int remaining;               // 아직 풀리지 않은 하위 블록 수
+} RaptorBlockDecoder;
+
+// 함수 선언
+bool InitRaptorObjectInfo(RaptorObjectInfo* oti, uint64_t F, int T, int Al, uint64_t W);
+int SourceBlockSymbols(const RaptorObjectInfo* oti, int sbn);
+uint64_t SourceBlockOffset(const RaptorObjectInfo* oti, int sbn);
+bool EncodeRaptorSourceBlock(const RaptorObjectInfo* oti, const uint8_t* object, int sbn, const uint16_t* esis, int numEsis, uint8_t* output);
+bool EncodeRaptorObject(const RaptorObjectInfo* oti, const uint8_t* object, const uint16_t* esis, int numEsis, uint8_t* output, threadPool* pool);
+bool DecodeRaptorSourceBlock(const RaptorObjectInfo* oti, int sbn, const ObjectSymbol* symbols, int numSymbols, uint8_t* object);
+RaptorBlockDecoder* NewRaptorBlockDecoder(const RaptorObjectInfo* oti, int sbn);
+bool AddRaptorBlockSymbols(RaptorBlockDecoder* decoder, const ObjectSymbol* symbols, int numSymbols);
+bool DecodeRaptorBlockInto(RaptorBlockDecoder* decoder, uint8_t* object);
+void FreeRaptorBlockDecoder(RaptorBlockDecoder* decoder);
+bool DecodeRaptorObject(const RaptorObjectInfo* oti, const ObjectSymbol* symbols, int numSymbols, uint8_t* object, threadPool* pool);
+
+#endif // OBJECT_H
@@ -2,15 +2,29 @@
 #define ONLINE_H
 
 #include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "soliton.h"
+#include "symbols.h"
+#include "inactivation.h"
 
 typedef struct {
     double epsilon;
     int quality;
     int numSourceBlocks;
     int64_t randomSeed;
-    double* cdf; // CDF 배열의 포인터
+    const degreeDist* degrees; // 차수 분포 (같은 epsilon의 코덱끼리 공유)
 } online_codec;
 
+// 원본 블록과 보조 블록(합성 블록)에 대한 GF(2) 방정식을 모으는 디코더
+typedef struct {
+    const online_codec* codec;  // 디코더보다 오래 살아야 함
+    int message_length;
+    int symbol_size;
+    int num_aux;
+    inactivation_decoder* matrix;
+} online_decoder;
+
 // 함수 프로토타입
 online_codec* create_online_codec(int sourceBlocks, double epsilon, int quality, int64_t seed);
 void destroy_online_codec(online_codec* codec);
@@ -18,7 +32,13 @@ void destroy_online_codec(online_codec* codec);
 int get_source_blocks(const online_codec* codec);
 int num_aux_blocks(const online_codec* codec);
 int estimate_decode_blocks_needed(const online_codec* codec);
-void generate_intermediate_blocks(const online_codec* codec, const uint8_t* message, size_t message_len, uint8_t** src_blocks, uint8_t** aux_blocks);
-void encode_online_blocks(const online_codec* codec, const int64_t* ids, size_t num_ids, uint8_t** blocks);
+int online_pick_indices(const online_codec* codec, int64_t codeBlockIndex, int* indices);
+symbolMatrix* generate_intermediate_blocks(const online_codec* codec, const uint8_t* message, size_t message_len);
+size_t encode_online_blocks(const online_codec* codec, const uint8_t* message, size_t message_len, const symbolMatrix* aux, const int64_t* ids, int num_ids, uint8_t* output);
+online_decoder* new_online_decoder(const online_codec* codec, int message_length);
+void destroy_online_decoder(online_decoder* decoder);
+int online_add_blocks(online_decoder* decoder, const int64_t* ids, const uint8_t* blocks, int numBlocks);
+bool online_decode_into(online_decoder* decoder, uint8_t* out);
+uint8_t* online_decode(online_decoder* decoder, int* out_length);
 
 #endif // ONLINE_H
\ No newline at end of file
@@ -0,0 +1,52 @@
+#ifndef PACKET_H
+#define PACKET_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "luby.h"
+
+// Wire format of one encoded block. Multi-byte fields are big-endian.
+//
+//   offset  size  field
+//        0     1  version (PACKET_VERSION)
+//        1     1  flags (PACKET_FLAG_*)
+//        2     2  source block number
+//        4     4  symbol size, the number of payload bytes
+//        8     8  ESI (LTBlock.blockCode)
+//       16     4  CRC-32C, only when PACKET_FLAG_CHECKSUM is set
+//   16 or 20      payload
+//
+// The checksum covers the first 16 header bytes followed by the payload.
+// Parsed blocks point into the receive buffer, so a batch of datagrams from
+// recvmmsg can be handed to AddBlocks without copying any payload.
+
+#define PACKET_VERSION 1
+#define PACKET_FLAG_CHECKSUM 0x01
+#define PACKET_HEADER_SIZE 16
+#define PACKET_CHECKSUM_SIZE 4
+
+// packetStatus enum: result of parsing one packet
+typedef enum {
+    PACKET_OK,
+    PACKET_TRUNCATED,    // Shorter than its header or declared payload
+    PACKET_BAD_VERSION,  // Unknown version or flags
+    PACKET_BAD_CHECKSUM  // Checksum present but does not match
+} packetStatus;
+
+// packetInfo structure: header fields of a parsed packet that LTBlock does not carry
+typedef struct {
+    uint16_t sourceBlock; // Source block number
+    bool checksummed;     // The packet carried a checksum and it matched
+    size_t size;          // Bytes the packet occupies (header plus payload)
+} packetInfo;
+
+// Function prototypes
+size_t PacketSize(size_t symbolSize, bool checksum);
+size_t WritePacket(uint8_t* buffer, size_t capacity, uint16_t sourceBlock, const LTBlock* block, bool checksum);
+size_t WritePackets(uint8_t* buffer, size_t capacity, uint16_t sourceBlock, const LTBlock* blocks, int numBlocks, bool checksum, size_t* offsets);
+packetStatus ParsePacket(const uint8_t* buffer, size_t length, packetInfo* info, LTBlock* block);
+int ParsePackets(const uint8_t* const* buffers, const size_t* lengths, int numPackets, uint16_t sourceBlock, LTBlock* blocks);
+const char* packetChecksumKernelName(void);
+
+#endif // PACKET_H
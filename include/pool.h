@@ -0,0 +1,17 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+typedef struct threadPool threadPool;
+
+// 병렬 작업 함수. [begin, end) 구간의 항목을 처리합니다.
+typedef void (*poolTask)(void* arg, int begin, int end);
+
+// 함수 선언
+threadPool* newThreadPool(int numThreads);
+void freeThreadPool(threadPool* pool);
+int threadPoolSize(const threadPool* pool);
+void threadPoolFor(threadPool* pool, int n, int grain, poolTask task, void* arg);
+
+#endif // POOL_H
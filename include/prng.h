@@ -0,0 +1,40 @@
+#ifndef PRNG_H
+#define PRNG_H
+
+#include <stdint.h>
+
+// 코덱이 블록 ID에서 인덱스를 뽑는 방식
+typedef enum {
+    PRNG_LIBC,    // srand(id) + rand(): 전역 상태를 쓰며 인덱스 후보마다 한 번씩 호출
+    PRNG_COUNTER, // (시드, 블록 ID)로 정해지는 카운터 기반 난수열
+    PRNG_MT19937  // 시드 ^ 블록 ID로 MT19937을 시드하고 앞쪽 몇 개만 뽑음 (drawMT)
+} prngMode;
+
+// counterRng 구조체: (시드, 블록 ID)로 정해지는 상태 없는 카운터 기반 난수열.
+// i번째 값은 SplitMix64 혼합 함수에 key + i를 넣은 결과라 전역 상태가 없고,
+// 같은 (시드, 블록 ID)이면 어느 스레드에서 만들어도 같은 수열이 나옵니다.
+typedef struct {
+    uint64_t key;
+    uint64_t counter;
+} counterRng;
+
+// SplitMix64 혼합 함수
+static inline uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// 블록 ID마다 서로 겹치지 않는 수열을 쓰도록 키를 한 번 더 섞습니다.
+static inline void counterRngInit(counterRng* r, uint64_t seed, int64_t blockId) {
+    r->key = splitmix64(seed ^ splitmix64((uint64_t)blockId));
+    r->counter = 0;
+}
+
+// 다음 64비트 난수
+static inline uint64_t counterRngNext(counterRng* r) {
+    return splitmix64(r->key + 0x9E3779B97F4A7C15ULL * r->counter++);
+}
+
+#endif // PRNG_H
@@ -2,15 +2,40 @@
 #define RAPTOR_H
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "inactivation.h"
+#include "symbols.h"
 
 #define MAX_SOURCE_SYMBOLS 8192
 #define MAX_BLOCK_SIZE 1024
 
+// raptor_params 구조체: K에만 의존하는 값들. K마다 한 번 계산해 두고
+// 기호마다 호출되는 함수들(triple_generator, find_lt_indices, lt_encode)이 함께 씁니다.
+typedef struct {
+    int K;            // 원본 기호의 수
+    int L, S, H;      // 중간 기호, LDPC 기호, Half 기호의 수
+    uint32_t Lprime;  // L 이상의 가장 작은 소수
+    uint32_t J;       // 체계적 인덱스 J(K)
+    uint32_t A, B;    // 트리플 생성기의 시드 (J(K)로 정해짐)
+} raptor_params;
+
 typedef struct {
     int SymbolAlignmentSize;
     int NumSourceSymbols;
+    raptor_params params; // NumSourceSymbols에 대한 값 (코덱 생성 시 계산)
 } RaptorCodec;
 
+// Raptor 디코더: L = K+S+H 중간 기호에 대한 비활성화(inactivation) 디코더
+typedef struct {
+    RaptorCodec codec;
+    int message_length;
+    int symbol_size;
+    raptor_params params;
+    inactivation_decoder* matrix;
+    int* source_rows;  // ESI i < K인 원본 기호가 들어간 행 (아직 없으면 -1)
+    int num_source;    // 받은 서로 다른 원본 기호의 수
+} raptor_decoder;
+
 // 함수 선언
 RaptorCodec* create_raptor_codec(int source_blocks, int alignment_size);
 void destroy_raptor_codec(RaptorCodec* codec);
@@ -18,14 +43,17 @@ void destroy_raptor_codec(RaptorCodec* codec);
 int raptor_rand(uint32_t x, uint32_t i, uint32_t m);
 int deg(uint32_t v);
 void intermediate_symbols(int k, int* L, int* S, int* H);
-void triple_generator(int k, uint16_t x, int* d, uint32_t* a, uint32_t* b);
-void find_lt_indices(int k, uint16_t x, int* indices, int* num_indices);
-void lt_encode(int k, uint16_t x, const uint8_t* c, uint8_t* result);
-void raptor_intermediate_blocks(const uint8_t* source, int num_blocks, uint8_t* intermediate_blocks);
-void generate_intermediate_blocks(const uint8_t* message, int message_length, int num_blocks, uint8_t* blocks);
-void pick_indices(int code_block_index, int* indices, int* num_indices);
+void raptor_params_init(raptor_params* p, int k);
+void triple_generator(const raptor_params* p, uint16_t x, int* d, uint32_t* a, uint32_t* b);
+void find_lt_indices(const raptor_params* p, uint16_t x, int* indices, int* num_indices);
+void lt_encode(const raptor_params* p, uint16_t x, const symbolMatrix* c, uint8_t* result);
+bool raptor_intermediate_blocks(const raptor_params* p, const symbolMatrix* source, symbolMatrix* intermediate_blocks);
+symbolMatrix* generate_intermediate_blocks(const raptor_params* p, const uint8_t* message, int message_length, int alignment);
+void pick_indices(const raptor_params* p, int code_block_index, int* indices, int* num_indices);
 void* new_decoder(const RaptorCodec* codec, int message_length);
-int add_blocks(void* decoder, const uint8_t* blocks, int num_blocks);
+void destroy_raptor_decoder(void* decoder);
+int add_blocks(void* decoder, const uint16_t* esis, const uint8_t* blocks, int num_blocks);
 uint8_t* decode(void* decoder, int* out_length);
+bool decode_into(void* decoder, uint8_t* out);
 
 #endif // RAPTOR_H
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef RAPTORQ_H
+#define RAPTORQ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inactivation.h"
+#include "symbols.h"
+
+#define RAPTORQ_MAX_SOURCE_SYMBOLS 56403
+
+// RaptorQ 방식(RFC 6330)의 코덱. 중간 기호 L = K+S+H개는 LT 기호 W개와 처음부터
+// 비활성인 PI 기호 P개로 나뉘고, 인코딩 기호는 LT 기호 d개와 PI 기호 d1개의 XOR입니다.
+// 제약 방정식은 LDPC 행 S개(GF(2))와 GF(256) 계수의 HDPC 행 H개입니다.
+// 구조는 RFC를 따르지만 Rand()의 V0..V3 표, 체계적 인덱스 표와 K' 패딩은 쓰지 않으므로
+// RFC 6330 구현과 기호 단위로 호환되지는 않습니다. 대신 K마다 ESI 0..K-1의 행과
+// 제약 방정식이 가역이 되는 가장 작은 체계적 인덱스 J를 찾아 둡니다.
+
+// raptorq_params 구조체: K에만 의존하는 값들. K마다 한 번 계산합니다.
+typedef struct {
+    int K;              // 원본 기호의 수
+    int S, H;           // LDPC 기호, HDPC 기호의 수
+    int W, B;           // LT 기호의 수 (소수), 그중 LDPC가 아닌 기호의 수 (W - S)
+    int P, P1;          // PI 기호의 수 (L - W), P 이상의 가장 작은 소수
+    int L;              // 중간 기호의 수
+    uint32_t J;         // 체계적 인덱스
+    const uint8_t* hdpc; // HDPC 행의 GF(256) 계수 (H x (K+S), 행 우선)
+} raptorq_params;
+
+// rq_tuple 구조체: ISI 하나의 인코딩 기호가 고르는 중간 기호 (RFC 6330 5.3.5.4)
+typedef struct {
+    int d, a, b;     // LT 기호의 수, 간격, 시작
+    int d1, a1, b1;  // PI 기호의 수, 간격, 시작
+} rq_tuple;
+
+typedef struct {
+    int SymbolAlignmentSize;
+    int NumSourceSymbols;
+    raptorq_params params; // NumSourceSymbols에 대한 값 (코덱 생성 시 계산)
+} RaptorQCodec;
+
+// RaptorQ 디코더: LDPC/LT 행은 GF(2), HDPC 행은 GF(256)인 비활성화 디코더
+typedef struct {
+    RaptorQCodec codec;
+    int message_length;
+    int symbol_size;
+    raptorq_params params;
+    inactivation_decoder* matrix;
+    int* source_rows;  // ESI i < K인 원본 기호가 들어간 행 (아직 없으면 -1)
+    int num_source;    // 받은 서로 다른 원본 기호의 수
+} raptorq_decoder;
+
+// 함수 선언
+RaptorQCodec* create_raptorq_codec(int source_blocks, int alignment_size);
+void destroy_raptorq_codec(RaptorQCodec* codec);
+
+uint32_t raptorq_rand(uint32_t y, uint32_t i, uint32_t m);
+int raptorq_deg(uint32_t v, int w);
+void raptorq_params_init(raptorq_params* p, int k);
+void raptorq_tuple(const raptorq_params* p, uint32_t x, rq_tuple* t);
+void raptorq_indices(const raptorq_params* p, uint32_t x, int* indices, int* num_indices);
+void raptorq_add_constraints(inactivation_decoder* dec, const raptorq_params* p);
+void raptorq_encode(const raptorq_params* p, uint32_t x, const symbolMatrix* c, uint8_t* result);
+bool raptorq_intermediate_blocks(const raptorq_params* p, const symbolMatrix* source, symbolMatrix* intermediate_blocks);
+symbolMatrix* raptorq_generate_intermediate_blocks(const raptorq_params* p, const uint8_t* message, int message_length, int alignment);
+void* raptorq_new_decoder(const RaptorQCodec* codec, int message_length);
+void raptorq_destroy_decoder(void* decoder);
+int raptorq_add_blocks(void* decoder, const uint32_t* esis, const uint8_t* blocks, int num_blocks);
+bool raptorq_decode_into(void* decoder, uint8_t* out);
+uint8_t* raptorq_decode(void* decoder, int* out_length);
+
+#endif // RAPTORQ_H
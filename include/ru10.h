@@ -2,18 +2,44 @@
 #define RU10_H
 
 #include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "inactivation.h"
+#include "symbols.h"
+#include "prng.h"
 
 typedef struct {
     int numSourceSymbols;
     int symbolAlignmentSize;
+    int l;           // Intermediate symbols for numSourceSymbols
+    int s, h;        // LDPC and Half symbols among them
+    int lprime;      // Smallest prime >= l
+    prngMode prng;   // May be switched to any mode before encoding
+    uint64_t seed;   // Used by PRNG_COUNTER and PRNG_MT19937
 } ru10_codec;
 
+// Inactivation decoder over the L = K+S+H intermediate symbols
+typedef struct {
+    ru10_codec codec;
+    int message_length;
+    int symbol_size;
+    int k, l, s, h;
+    inactivation_decoder* matrix;
+} ru10_decoder;
+
 // Function prototypes
 ru10_codec* create_ru10_codec(int numSourceSymbols, int symbolAlignmentSize);
+ru10_codec* create_ru10_codec_seeded(int numSourceSymbols, int symbolAlignmentSize, uint64_t seed);
+ru10_codec* create_ru10_codec_mt19937(int numSourceSymbols, int symbolAlignmentSize, uint64_t seed);
 void destroy_ru10_codec(ru10_codec* codec);
 
 int get_source_blocks(const ru10_codec* codec);
 int pick_indices(const ru10_codec* codec, int64_t codeBlockIndex, int* indices, int maxIndices);
-void generate_intermediate_blocks(const ru10_codec* codec, const uint8_t* message, size_t message_len, uint8_t** blocks, int* numBlocks);
+symbolMatrix* generate_intermediate_blocks(const ru10_codec* codec, const uint8_t* message, size_t message_len);
+ru10_decoder* new_ru10_decoder(const ru10_codec* codec, int message_length);
+void destroy_ru10_decoder(ru10_decoder* decoder);
+int ru10_add_blocks(ru10_decoder* decoder, const int64_t* ids, const uint8_t* blocks, int numBlocks);
+uint8_t* ru10_decode(ru10_decoder* decoder, int* out_length);
+bool ru10_decode_into(ru10_decoder* decoder, uint8_t* out);
 
 #endif // RU10_H
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef SAMPLE_H
+#define SAMPLE_H
+
+#include <stdbool.h>
+
+// Largest sample whose membership is checked by scanning the output; bigger
+// samples use a hash set
+#define SAMPLE_LINEAR_MAX 32
+
+// Function prototypes
+int sampleUniformInto(unsigned int* seed, int d, int max, int* out, bool sorted);
+
+#endif // SAMPLE_H
@@ -0,0 +1,45 @@
+#ifndef SOLITON_H
+#define SOLITON_H
+
+#include <stdbool.h>
+#include "alias.h"
+
+// 차수 분포의 종류. 캐시 키의 일부입니다.
+typedef enum {
+    DEGREE_SOLITON,
+    DEGREE_ROBUST_SOLITON,
+    DEGREE_ONLINE_SOLITON,
+    DEGREE_CUSTOM  // 호출자가 넘긴 CDF (캐시하지 않음)
+} degreeKind;
+
+// degreeDist 구조체: 한 번 만들면 바뀌지 않는 차수 분포. 같은 매개변수의
+// 코덱들은 프로세스 전체 캐시에서 하나를 공유하고, 참조 수로 수명을 관리합니다.
+typedef struct degreeDist {
+    degreeKind kind;   // 키: 분포 종류
+    int n;             // 키: 원본 블록 수 (soliton, robust)
+    int m;             // 키: robust soliton의 spike 위치
+    double delta;      // 키: robust soliton의 실패 확률
+    double epsilon;    // 키: online soliton의 오버헤드
+    double* cdf;       // cdf[d] = P(차수 <= d), cdf[0] = 0
+    int size;          // 최대 차수 + 1
+    aliasTable* table; // 표본이 곧 차수인 별칭 테이블
+    int refs;          // 참조 수 (캐시 잠금 아래에서만 바뀜)
+    bool cached;       // 캐시 목록에 들어 있는지
+    struct degreeDist* next;
+} degreeDist;
+
+// 분포 계산. cdf는 malloc으로 잡으며 인덱스가 곧 차수입니다.
+void solitonDistribution(int n, double** cdf, int* size);
+void robustSolitonDistribution(int n, int m, double delta, double** cdf, int* size);
+void onlineSolitonDistribution(double eps, double** cdf, int* size);
+
+// 공유 분포. 모두 참조 하나를 돌려주며 releaseDegreeDist로 반납합니다.
+const degreeDist* acquireSoliton(int n);
+const degreeDist* acquireRobustSoliton(int n, int m, double delta);
+const degreeDist* acquireOnlineSoliton(double epsilon);
+const degreeDist* wrapDegreeCDF(double* cdf, int size);
+const degreeDist* retainDegreeDist(const degreeDist* d);
+void releaseDegreeDist(const degreeDist* d);
+void trimDegreeDistCache(void);
+
+#endif // SOLITON_H
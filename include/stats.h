@@ -0,0 +1,74 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// 디코더 계측. FOUNTAIN_STATS를 정의하고 빌드하면 디코더가 아래 카운터를
+// 갱신하고, 정의하지 않으면 STATS_* 매크로가 카운터를 건드리지 않습니다.
+// 구조체 배치가 빌드 옵션에 따라 달라지지 않도록 stats 필드는 항상 둡니다.
+//
+//   Luby                        decoder->Stats(decoder)
+//   binary                      decoder->matrix.stats
+//   raptor, raptorq, ru10, online  decoder->matrix->stats
+//
+// formatDecoderStats는 벤치마크 출력과 같은 JSON 한 줄을 만들어 그대로
+// 메트릭 수집기로 보낼 수 있게 합니다.
+
+// decoderStats 구조체: 디코더 하나의 누적 카운터
+typedef struct {
+    uint64_t symbolsAdded;        // 디코더에 넣은 기호 수
+    uint64_t redundantSymbols;    // 새 정보가 없었던 기호 수
+    uint64_t xorBytes;            // 기호 값에 XOR한 바이트 수 (GF(256) 곱-누산 포함)
+    uint64_t rowMerges;           // 방정식 두 개를 더한 횟수
+    uint64_t peeled;              // 차수 1인 방정식으로 정한 미지수 수
+    uint64_t eliminated;          // 소거로 정한 미지수 수
+    uint64_t inactivated;         // 비활성으로 옮긴 열 수 (비활성화 디코더)
+    int numCols;                  // 풀어야 할 미지수 수
+    int rank;                     // 지금까지 정해진 랭크 (numCols에 이르면 풀림)
+    uint64_t symbolsAtDetermined; // 처음 풀 수 있게 되었을 때의 symbolsAdded (아직이면 0)
+    uint64_t addNanos;            // 기호 추가에 쓴 시간
+    uint64_t peelNanos;           // peeling에 쓴 시간 (Luby는 addNanos에도 포함)
+    uint64_t eliminateNanos;      // 소거에 쓴 시간
+    uint64_t backsubNanos;        // 역대입에 쓴 시간
+    size_t peakBytes;             // 디코더가 잡은 메모리의 최댓값
+} decoderStats;
+
+#ifdef FOUNTAIN_STATS
+
+#include <time.h>
+
+static inline uint64_t statsNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+#define STATS_ADD(s, field, n) ((s)->field += (n))
+#define STATS_SET(s, field, v) ((s)->field = (v))
+#define STATS_MAX(s, field, v) ((s)->field = (v) > (s)->field ? (v) : (s)->field)
+// 처음 풀 수 있게 된 시점을 한 번만 기록합니다.
+#define STATS_DETERMINED(s) \
+    ((s)->symbolsAtDetermined = (s)->symbolsAtDetermined ? (s)->symbolsAtDetermined : (s)->symbolsAdded)
+#define STATS_TIMER(t) uint64_t t = statsNow()
+#define STATS_ELAPSED(s, field, t) ((s)->field += statsNow() - (t))
+
+#else
+
+// 꺼져 있어도 s는 평가하고 값은 sizeof로만 참조해, stats 인자나 카운트만 담는
+// 변수가 쓰이지 않는다는 경고가 나지 않게 합니다.
+#define STATS_ADD(s, field, n) ((void)(s), (void)sizeof(n))
+#define STATS_SET(s, field, v) ((void)(s), (void)sizeof(v))
+#define STATS_MAX(s, field, v) ((void)(s), (void)sizeof(v))
+#define STATS_DETERMINED(s) ((void)(s))
+#define STATS_TIMER(t) ((void)0)
+#define STATS_ELAPSED(s, field, t) ((void)(s))
+
+#endif // FOUNTAIN_STATS
+
+// 함수 선언
+bool decoderStatsEnabled(void);
+int formatDecoderStats(char* buffer, size_t capacity, const char* codec, const decoderStats* stats);
+
+#endif // STATS_H
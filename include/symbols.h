@@ -0,0 +1,33 @@
+#ifndef SYMBOLS_H
+#define SYMBOLS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// symbolMatrix 구조체: 기호 count개를 연속 메모리 하나에 stride 간격으로 저장합니다.
+// 직접 잡은 메모리는 64바이트 정렬이고, stride는 symbolSize를 정렬 크기
+// (SymbolAlignmentSize)의 배수로 올린 값이라 정렬 크기가 64의 배수이면 모든 기호가
+// 64바이트 정렬됩니다. 호출자의 버퍼를 감싼 뷰는 owned가 false입니다.
+typedef struct {
+    uint8_t* data;   // 기호 데이터
+    int count;       // 기호의 수
+    int symbolSize;  // 기호 하나의 유효 바이트 수
+    int stride;      // 기호 사이의 간격
+    bool owned;      // freeSymbolMatrix가 data를 해제하는지 여부
+} symbolMatrix;
+
+// i번째 기호의 시작 위치
+static inline uint8_t* symbolAt(const symbolMatrix* m, int i) {
+    return m->data + (size_t)i * m->stride;
+}
+
+// 함수 선언
+symbolMatrix* newSymbolMatrix(int count, int symbolSize, int alignment);
+symbolMatrix* viewSymbols(uint8_t* buffer, int count, int symbolSize);
+void freeSymbolMatrix(symbolMatrix* m);
+symbolMatrix* partitionSymbols(const uint8_t* message, int messageLength, int numSymbols, int alignment);
+size_t symbolBufferSize(int messageLength, int numSymbols);
+void compactSymbols(symbolMatrix* m, int numSymbols, int messageLength);
+
+#endif // SYMBOLS_H
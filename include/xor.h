@@ -0,0 +1,19 @@
+#ifndef XOR_H
+#define XOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// XOR kernel shared by every codec. The widest kernel supported by the CPU
+// (AVX-512, AVX2, SSE2 or a 64-bit scalar fallback) is selected at runtime.
+
+// dst ^= src
+void xorBytes(uint8_t* dst, const uint8_t* src, size_t length);
+// dst ^= srcs[0] ^ srcs[1] ^ ... ^ srcs[numSrcs-1], in a single pass over dst
+void xorBytesMulti(uint8_t* dst, const uint8_t* const* srcs, int numSrcs, size_t length);
+// dst = srcs[0] ^ srcs[1] ^ ... ^ srcs[numSrcs-1], dst is never read (zeroed when numSrcs == 0)
+void xorBytesGather(uint8_t* dst, const uint8_t* const* srcs, int numSrcs, size_t length);
+// Name of the selected kernel ("avx512", "avx2", "sse2" or "scalar64")
+const char* xorKernelName(void);
+
+#endif // XOR_H
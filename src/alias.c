@@ -0,0 +1,78 @@
+#include <stdlib.h>
+#include "alias.h"
+
+// CDF로 별칭 테이블 생성 (Vose). cdf는 soliton.c의 분포처럼 인덱스가 차수이고
+// cdf[0]은 쓰지 않습니다. 항목 i (1 <= i < size)의 확률은 cdf[i] - cdf[i-1]이고,
+// 첫 항목은 cdf[1] 그대로입니다.
+aliasTable* newAliasTable(const double* cdf, int size) {
+    int n = size - 1;
+    aliasTable* t = (aliasTable*)malloc(sizeof(aliasTable));
+    t->n = n;
+    t->prob = (double*)malloc(n * sizeof(double));
+    t->alias = (int*)malloc(n * sizeof(int));
+
+    // 확률에 n을 곱해 평균이 1이 되게 하고, 1보다 작은 칸과 큰 칸으로 나눕니다.
+    double total = cdf[size - 1];
+    double* scaled = (double*)malloc(n * sizeof(double));
+    int* small = (int*)malloc(n * sizeof(int));
+    int* large = (int*)malloc(n * sizeof(int));
+    int numSmall = 0, numLarge = 0;
+    for (int i = 0; i < n; i++) {
+        double p = cdf[1 + i] - (i > 0 ? cdf[i] : 0.0);
+        scaled[i] = (p > 0 ? p : 0.0) * n / total;
+        if (scaled[i] < 1.0) {
+            small[numSmall++] = i;
+        } else {
+            large[numLarge++] = i;
+        }
+    }
+
+    // 작은 칸은 큰 항목 하나로 채우고, 큰 항목의 남은 확률로 다시 분류합니다.
+    while (numSmall > 0 && numLarge > 0) {
+        int s = small[--numSmall];
+        int l = large[--numLarge];
+        t->prob[s] = scaled[s];
+        t->alias[s] = l;
+        scaled[l] -= 1.0 - scaled[s];
+        if (scaled[l] < 1.0) {
+            small[numSmall++] = l;
+        } else {
+            large[numLarge++] = l;
+        }
+    }
+    // 반올림 오차로 남은 칸은 자기 자신만 가리킵니다.
+    while (numLarge > 0) {
+        int l = large[--numLarge];
+        t->prob[l] = 1.0;
+        t->alias[l] = l;
+    }
+    while (numSmall > 0) {
+        int s = small[--numSmall];
+        t->prob[s] = 1.0;
+        t->alias[s] = s;
+    }
+
+    free(scaled);
+    free(small);
+    free(large);
+    return t;
+}
+
+void freeAliasTable(aliasTable* t) {
+    if (t != NULL) {
+        free(t->prob);
+        free(t->alias);
+        free(t);
+    }
+}
+
+// 균등 난수 u (0 <= u < 1) 하나로 차수(1 이상)를 뽑습니다. 정수 부분이 칸을,
+// 소수 부분이 그 칸 안의 선택을 정합니다.
+int aliasSample(const aliasTable* t, double u) {
+    double x = u * t->n;
+    int i = (int)x;
+    if (i >= t->n) {
+        i = t->n - 1;
+    }
+    return 1 + (x - i < t->prob[i] ? i : t->alias[i]);
+}
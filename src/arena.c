@@ -0,0 +1,101 @@
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+#define ARENA_ALIGN 16
+#define ARENA_SYMBOL_ALIGN 64
+#define ARENA_DEFAULT_SLAB (1 << 20)
+
+struct arenaSlab {
+    arenaSlab* prev;
+    size_t size;
+    size_t used;
+    uint8_t* data;
+};
+
+static size_t alignUp(size_t x, size_t align) {
+    return (x + align - 1) & ~(align - 1);
+}
+
+// 최소 size 바이트를 담을 새 슬랩을 현재 슬랩으로 만듭니다.
+static arenaSlab* newSlab(arena* a, size_t size) {
+    size_t bytes = size > a->slabSize ? size : a->slabSize;
+    arenaSlab* s = (arenaSlab*)malloc(sizeof(arenaSlab));
+    s->data = (uint8_t*)aligned_alloc(ARENA_SYMBOL_ALIGN, alignUp(bytes, ARENA_SYMBOL_ALIGN));
+    s->size = bytes;
+    s->used = 0;
+    s->prev = a->head;
+    a->head = s;
+    a->reserved += bytes;
+    return s;
+}
+
+// 아레나 초기화. slabSize가 0이면 1 MiB 슬랩을 씁니다.
+void arenaInit(arena* a, size_t symbolSize, size_t slabSize) {
+    a->head = NULL;
+    a->slabSize = slabSize > 0 ? slabSize : ARENA_DEFAULT_SLAB;
+    a->symbolSize = symbolSize;
+    a->freeSymbols = NULL;
+    a->reserved = 0;
+}
+
+static void* allocAligned(arena* a, size_t size, size_t align) {
+    arenaSlab* s = a->head;
+    size_t offset = s ? alignUp(s->used, align) : 0;
+    if (s == NULL || offset + size > s->size) {
+        s = newSlab(a, size);
+        offset = 0;
+    }
+    s->used = offset + size;
+    return s->data + offset;
+}
+
+void* arenaAlloc(arena* a, size_t size) {
+    return allocAligned(a, size > 0 ? size : 1, ARENA_ALIGN);
+}
+
+// symbolSize 바이트의 64바이트 정렬 버퍼. 반납된 버퍼가 있으면 재사용합니다.
+uint8_t* arenaSymbol(arena* a) {
+    if (a->freeSymbols != NULL) {
+        uint8_t* symbol = (uint8_t*)a->freeSymbols;
+        memcpy(&a->freeSymbols, symbol, sizeof(void*));
+        return symbol;
+    }
+    size_t size = a->symbolSize > sizeof(void*) ? a->symbolSize : sizeof(void*);
+    return (uint8_t*)allocAligned(a, size, ARENA_SYMBOL_ALIGN);
+}
+
+void arenaRelease(arena* a, uint8_t* symbol) {
+    if (symbol != NULL) {
+        memcpy(symbol, &a->freeSymbols, sizeof(void*));
+        a->freeSymbols = symbol;
+    }
+}
+
+arenaMark arenaSave(arena* a) {
+    arenaMark mark;
+    mark.slab = a->head;
+    mark.used = a->head ? a->head->used : 0;
+    return mark;
+}
+
+// mark 이후에 잡은 메모리를 모두 돌려줍니다. 그 사이 arenaSymbol로 받은
+// 버퍼도 함께 사라지므로 임시 버퍼 용도로만 씁니다.
+void arenaRewind(arena* a, arenaMark mark) {
+    while (a->head != mark.slab) {
+        arenaSlab* s = a->head;
+        a->head = s->prev;
+        a->reserved -= s->size;
+        free(s->data);
+        free(s);
+    }
+    if (a->head != NULL) {
+        a->head->used = mark.used;
+    }
+}
+
+void arenaFree(arena* a) {
+    arenaMark empty = {NULL, 0};
+    arenaRewind(a, empty);
+    a->freeSymbols = NULL;
+}
@@ -3,15 +3,37 @@
 #include <string.h>
 #include <stdbool.h>
 #include <math.h>
+#include <limits.h>
 #include "../include/binary.h"
 #include "../include/block.h"
 #include "../include/luby.h"
-#include "util.c"
 
+// Blocks per batch in AddBlocks
+#define ADD_BATCH 64
+
+// batchEntry structure: one block of an AddBlocks batch and its index set
+typedef struct {
+    int lowest; // Lowest source block in the set (the row it lands on)
+    int block;  // Position of the block in the batch
+    int offset; // Start of the set in the decoder's batch buffer
+    int count;  // Size of the set
+} batchEntry;
 
 binaryCodec* NewBinaryCodec(int numSourceBlocks) {
     binaryCodec* codec = (binaryCodec*)malloc(sizeof(binaryCodec));
     codec->numSourceBlocks = numSourceBlocks;
+    codec->prng = PRNG_LIBC;
+    codec->seed = 0;
+    return codec;
+}
+
+// Creates a codec that picks indices with the counter-based generator. It
+// needs no global state, so PickIndices can run on many threads at once, and
+// it draws the inclusion mask 64 source blocks at a time.
+binaryCodec* NewBinaryCodecSeeded(int numSourceBlocks, uint64_t seed) {
+    binaryCodec* codec = NewBinaryCodec(numSourceBlocks);
+    codec->prng = PRNG_COUNTER;
+    codec->seed = seed;
     return codec;
 }
 
@@ -19,71 +41,162 @@ int BinaryCodec_SourceBlocks(binaryCodec* c) {
     return c->numSourceBlocks;
 }
 
-int* PickIndices(binaryCodec* codec, int64_t codeBlockIndex, int* outLength) {
+// Writes the indices for a code block into caller-provided scratch, which must
+// hold numSourceBlocks ints. Returns the number of indices written.
+int PickIndicesInto(binaryCodec* codec, int64_t codeBlockIndex, int* indices) {
+    int count = 0;
+    if (codec->prng == PRNG_COUNTER) {
+        counterRng rng;
+        counterRngInit(&rng, codec->seed, codeBlockIndex);
+        for (int base = 0; base < codec->numSourceBlocks; base += 64) {
+            uint64_t mask = counterRngNext(&rng);
+            int remaining = codec->numSourceBlocks - base;
+            if (remaining < 64) {
+                mask &= (1ULL << remaining) - 1;
+            }
+            while (mask) {
+                indices[count++] = base + __builtin_ctzll(mask);
+                mask &= mask - 1;
+            }
+        }
+        return count;
+    }
+
     srand((unsigned int)codeBlockIndex); // Seed random generator
 
-    int* indices = (int*)malloc(codec->numSourceBlocks * sizeof(int));
-    int count = 0;
     for (int b = 0; b < codec->numSourceBlocks; b++) {
         if (rand() % 2 == 1) {
             indices[count++] = b;
         }
     }
+    return count;
+}
 
-    *outLength = count;
+int* PickIndices(binaryCodec* codec, int64_t codeBlockIndex, int* outLength) {
+    int* indices = (int*)malloc(codec->numSourceBlocks * sizeof(int));
+    *outLength = PickIndicesInto(codec, codeBlockIndex, indices);
     return indices;
 }
 
-block* GenerateIntermediateBlocks(binaryCodec* codec, uint8_t* message, int messageLength, int numBlocks) {
-    int longBlockSize, shortBlockSize;
-    int** partitions = PartitionBytes(message, messageLength, codec->numSourceBlocks, &longBlockSize, &shortBlockSize);
-    block* source = equalizeBlockLengths(partitions, partitions + codec->numSourceBlocks, codec->numSourceBlocks, codec->numSourceBlocks, longBlockSize, shortBlockSize);
-    
-    for (int i = 0; i < codec->numSourceBlocks; i++) {
-        free(partitions[i]);
-    }
-    free(partitions);
-
-    return source;
+// The binary code is not pre-coded: the intermediate blocks are the source
+// blocks, padded to equal length in one contiguous buffer.
+symbolMatrix* GenerateIntermediateBlocks(binaryCodec* codec, uint8_t* message, int messageLength, int numBlocks) {
+    return partitionSymbols(message, messageLength, codec->numSourceBlocks, 1);
 }
 
 binaryDecoder* NewDecoder(binaryCodec* codec, int messageLength) {
     binaryDecoder* decoder = (binaryDecoder*)malloc(sizeof(binaryDecoder));
     decoder->codec = *codec;
     decoder->messageLength = messageLength;
-    decoder->matrix.coeff = (int**)malloc(codec->numSourceBlocks * sizeof(int*));
-    decoder->matrix.v = (block*)malloc(codec->numSourceBlocks * sizeof(block));
-    decoder->matrix.numRows = codec->numSourceBlocks;
+    decoder->symbolSize = (messageLength + codec->numSourceBlocks - 1) / codec->numSourceBlocks;
+    decoder->batch = NULL;
+    decoder->batchCap = 0;
+    initSparseMatrix(&decoder->matrix, codec->numSourceBlocks, decoder->symbolSize);
     return decoder;
 }
 
-bool AddBlocks(binaryDecoder* decoder, LTBlock* blocks, int numBlocks) {
+void FreeDecoder(binaryDecoder* decoder) {
+    if (decoder != NULL) {
+        freeSparseMatrix(&decoder->matrix);
+        free(decoder->batch);
+        free(decoder);
+    }
+}
+
+// Bytes held by the decoder: the matrix arena, its row tables and the batch buffer
+static inline size_t decoderBytes(const binaryDecoder* decoder) {
+    size_t rows = decoder->matrix.numRows > 0 ? decoder->matrix.numRows : 1;
+    return decoder->matrix.mem.reserved + rows * (sizeof(int*) + sizeof(int) + sizeof(block) + 2 * sizeof(int)) +
+        (size_t)decoder->batchCap * sizeof(int);
+}
+
+static int compareBatchEntries(const void* a, const void* b) {
+    const batchEntry* x = (const batchEntry*)a;
+    const batchEntry* y = (const batchEntry*)b;
+    if (x->lowest != y->lowest) {
+        return x->lowest < y->lowest ? -1 : 1;
+    }
+    return (x->block > y->block) - (x->block < y->block);
+}
+
+// Generates the index sets of a batch of blocks back to back in the decoder's
+// batch buffer, then orders the batch by lowest index. A new equation starts
+// at the row of its lowest index, so sorted insertion walks the matrix rows
+// in order instead of jumping around.
+static void pickBatch(binaryDecoder* decoder, const LTBlock* blocks, int numBlocks, batchEntry* entries) {
+    int cap = decoder->codec.numSourceBlocks;
+    int used = 0;
     for (int i = 0; i < numBlocks; i++) {
-        int outLength = 0;
-        int* indices = PickIndices(&decoder->codec, blocks[i].blockCode, &outLength);
-        
-        // Assuming addEquation is a function that needs to be implemented
-        // decoder->matrix.addEquation(indices, block{data: blocks[i].Data, length: blocks[i].length});
-        
-        free(indices);
+        if (used + cap > decoder->batchCap) {
+            decoder->batchCap = used + cap > 2 * decoder->batchCap ? used + cap : 2 * decoder->batchCap;
+            decoder->batch = (int*)realloc(decoder->batch, decoder->batchCap * sizeof(int));
+        }
+        // Indices come out sorted, so the first is the lowest
+        int count = PickIndicesInto(&decoder->codec, blocks[i].blockCode, decoder->batch + used);
+        entries[i].lowest = count > 0 ? decoder->batch[used] : INT_MAX;
+        entries[i].block = i;
+        entries[i].offset = used;
+        entries[i].count = count;
+        used += count;
     }
-    return true; 
+    qsort(entries, numBlocks, sizeof(batchEntry), compareBatchEntries);
+}
+
+// Adds blocks to the decoder, ADD_BATCH at a time: the index sets of a batch
+// are generated together and inserted in order of their lowest index. Returns
+// true as soon as the matrix reaches full rank, so callers can stop feeding
+// blocks without any extra scan.
+bool AddBlocks(binaryDecoder* decoder, LTBlock* blocks, int numBlocks) {
+    STATS_TIMER(t0);
+    batchEntry entries[ADD_BATCH];
+    for (int start = 0; start < numBlocks && !determined(&decoder->matrix); start += ADD_BATCH) {
+        int n = numBlocks - start < ADD_BATCH ? numBlocks - start : ADD_BATCH;
+        pickBatch(decoder, blocks + start, n, entries);
+        for (int i = 0; i < n && !determined(&decoder->matrix); i++) {
+            if (entries[i].count == 0) {
+                continue;
+            }
+
+            // The matrix copies the indices and owns its arena copy of the block data
+            const LTBlock* received = &blocks[start + entries[i].block];
+            size_t len = received->length < (size_t)decoder->symbolSize ? received->length : (size_t)decoder->symbolSize;
+            block b;
+            b.length = decoder->symbolSize;
+            b.padding = 0;
+            b.data = arenaSymbol(&decoder->matrix.mem);
+            memcpy(b.data, received->data, len);
+            memset(b.data + len, 0, decoder->symbolSize - len);
+            addEquation(&decoder->matrix, decoder->batch + entries[i].offset, entries[i].count, b);
+        }
+    }
+    STATS_ELAPSED(&decoder->matrix.stats, addNanos, t0);
+    STATS_MAX(&decoder->matrix.stats, peakBytes, decoderBytes(decoder));
+    return determined(&decoder->matrix);
+}
+
+// Decodes into a caller buffer of at least symbolBufferSize(messageLength,
+// numSourceBlocks) bytes. Back-substitution writes every source block straight
+// into it, so the message needs no separate copy.
+bool DecodeInto(binaryDecoder* decoder, uint8_t* out) {
+    if (!determined(&decoder->matrix)) {
+        return false;
+    }
+
+    symbolMatrix* source = viewSymbols(out, decoder->codec.numSourceBlocks, decoder->symbolSize);
+    Reduce(&decoder->matrix, source);
+    compactSymbols(source, decoder->codec.numSourceBlocks, decoder->messageLength);
+    freeSymbolMatrix(source);
+    return true;
 }
 
 uint8_t* Decode(binaryDecoder* decoder, int* outLength) {
-    if (!true) { 
+    if (!determined(&decoder->matrix)) {
         *outLength = 0;
         return NULL;
     }
 
-    decoder->Reduce();
-
-    int lenLong, lenShort, numLong, numShort;
-    partition(decoder->messageLength, decoder->codec.numSourceBlocks, &lenLong, &lenShort, &numLong, &numShort);
-    
-    return decoder->Reconstruct(decoder->messageLength, lenLong, lenShort, numLong, numShort);
-
-    *outLength = decoder->messageLength; 
-    uint8_t* result = (uint8_t*)malloc(decoder->messageLength * sizeof(uint8_t));
-    return result;
-}
\ No newline at end of file
+    uint8_t* out = (uint8_t*)malloc(symbolBufferSize(decoder->messageLength, decoder->codec.numSourceBlocks));
+    DecodeInto(decoder, out);
+    *outLength = decoder->messageLength;
+    return out;
+}
@@ -3,7 +3,8 @@
 #include <string.h>
 #include <stdbool.h>
 #include "block.h"
-#include "util.c"
+#include "xor.h"
+#include "arena.h"
 
 // 블록 생성
 block* newBlock(int len) {
@@ -24,69 +25,87 @@ bool blockEmpty(block* b) {
 void blockXor(block* b, block* a) {
     if (b->length < a->length) {
         b->data = (uint8_t*)realloc(b->data, a->length);
+        memset(b->data + b->length, 0, a->length - b->length);
         if (b->padding > a->length - b->length) {
             b->padding -= a->length - b->length;
         } else {
             b->padding = 0;
         }
+        b->length = a->length;
     }
 
-    for (int i = 0; i < a->length; i++) {
-        b->data[i] ^= a->data[i];
-    }
+    xorBytes(b->data, a->data, a->length);
 }
 
-int** PartitionBytes(uint8_t* in, int inLen, int p) {
-    int lenLong, lenShort;
-
-    partition(inLen, p, &lenLong, &lenShort, numLong, numShort);
+// 희소 행렬 초기화. numRows개의 빈 행으로 시작합니다. 행의 인덱스와
+// symbolSize 바이트의 값은 모두 행렬의 아레나에서 잡습니다.
+void initSparseMatrix(sparseMatrix* m, int numRows, int symbolSize) {
+    m->coeff = (int**)calloc(numRows, sizeof(int*));
+    m->coeffLen = (int*)calloc(numRows, sizeof(int));
+    m->v = (block*)calloc(numRows, sizeof(block));
+    m->numRows = numRows;
+    m->rank = 0;
+    m->solved = 0;
+    arenaInit(&m->mem, symbolSize, 0);
+    m->scratch[0] = (int*)malloc(2 * (numRows > 0 ? numRows : 1) * sizeof(int));
+    m->scratch[1] = m->scratch[0] + (numRows > 0 ? numRows : 1);
+    memset(&m->stats, 0, sizeof(m->stats));
+    m->stats.numCols = numRows;
+}
 
-    *longBlocks = (block*)malloc((*numLong) * sizeof(block));
-    *shortBlocks = (block*)malloc((*numShort) * sizeof(block));
+void freeSparseMatrix(sparseMatrix* m) {
+    arenaFree(&m->mem);
+    free(m->scratch[0]);
+    free(m->coeff);
+    free(m->coeffLen);
+    free(m->v);
+}
 
-    for (int i = 0; i < *numLong; i++) {
-        (*longBlocks)[i].data = (uint8_t*)malloc(lenLong);
-        if (inLen >= lenLong) {
-            memcpy((*longBlocks)[i].data, in, lenLong);
-            (*longBlocks)[i].length = lenLong;
-            (*longBlocks)[i].padding = 0;
-            in += lenLong;
-            inLen -= lenLong;
-        } else {
-            memcpy((*longBlocks)[i].data, in, inLen);
-            (*longBlocks)[i].length = inLen;
-            (*longBlocks)[i].padding = lenLong - inLen;
-            inLen = 0;
-        }
-    }
+// 행 인덱스를 아레나로 복사합니다.
+static int* storeRow(sparseMatrix* m, const int* components, int numComponents) {
+    int* row = (int*)arenaAlloc(&m->mem, numComponents * sizeof(int));
+    memcpy(row, components, numComponents * sizeof(int));
+    return row;
+}
 
-    for (int i = 0; i < *numShort; i++) {
-        (*shortBlocks)[i].data = (uint8_t*)malloc(lenShort);
-        if (inLen >= lenShort) {
-            memcpy((*shortBlocks)[i].data, in, lenShort);
-            (*shortBlocks)[i].length = lenShort;
-            (*shortBlocks)[i].padding = 0;
-            in += lenShort;
-            inLen -= lenShort;
+// 이미 하나의 원본 블록으로 풀린 행을 새 방정식의 꼬리에서 바로 제거합니다.
+// 첫 인덱스(피벗)는 그대로 두므로 행렬의 삼각 형태는 유지됩니다.
+static int substituteSolved(sparseMatrix* m, int* components, int numComponents, block* b) {
+    int n = 1;
+    for (int i = 1; i < numComponents; i++) {
+        int j = components[i];
+        if (m->coeff[j] != NULL && m->coeffLen[j] == 1) {
+            blockXor(b, &m->v[j]);
+            STATS_ADD(&m->stats, xorBytes, m->v[j].length);
         } else {
-            memcpy((*shortBlocks)[i].data, in, inLen);
-            (*shortBlocks)[i].length = inLen;
-            (*shortBlocks)[i].padding = lenShort - inLen;
-            inLen = 0;
+            components[n++] = j;
         }
     }
+    return n;
 }
 
+// 방정식 추가. components는 정렬된 인덱스 배열로 행렬이 필요한 만큼 복사하고,
+// b.data는 arenaSymbol(&m->mem)으로 받은 버퍼여야 하며 행렬이 소유권을 가져갑니다.
+// 행렬은 항상 coeff[i][0] == i인 삼각 형태를 유지하고, 새 피벗이 생길 때마다
+// rank가 1 늘어납니다. 진행 중인 행은 두 개의 scratch 버퍼를 번갈아 씁니다.
 void addEquation(sparseMatrix* m, int* components, int numComponents, block b) {
+    STATS_ADD(&m->stats, symbolsAdded, 1);
     while (numComponents > 0 && m->coeff[components[0]] != NULL) {
         int s = components[0];
-        if (numComponents >= sizeof(m->coeff[s]) / sizeof(int)) {
-            components = xorRow(s, components, numComponents, &b, &numComponents, &b);
+        if (numComponents >= m->coeffLen[s]) {
+            size_t newLen;
+            components = xorRow(m, s, components, numComponents, &b, &newLen);
+            numComponents = (int)newLen;
         } else {
-            
             int* tempComponents = m->coeff[s];
-            m->coeff[s] = components;
+            int tempLen = m->coeffLen[s];
+            m->coeff[s] = storeRow(m, components, numComponents);
+            m->coeffLen[s] = numComponents;
+            if (numComponents == 1) {
+                m->solved++;
+            }
             components = tempComponents;
+            numComponents = tempLen;
 
             block tempBlock = m->v[s];
             m->v[s] = b;
@@ -95,25 +114,42 @@ void addEquation(sparseMatrix* m, int* components, int numComponents, block b) {
     }
 
     if (numComponents > 0) {
-        m->coeff[components[0]] = components;
-        m->v[components[0]] = b;
+        int* row = storeRow(m, components, numComponents);
+        numComponents = substituteSolved(m, row, numComponents, &b);
+        int s = row[0];
+        m->coeff[s] = row;
+        m->coeffLen[s] = numComponents;
+        m->v[s] = b;
+        m->rank++;
+        if (numComponents == 1) {
+            m->solved++;
+        }
+    } else {
+        // 중복된 방정식
+        arenaRelease(&m->mem, b.data);
+        STATS_ADD(&m->stats, redundantSymbols, 1);
+    }
+    STATS_SET(&m->stats, rank, m->rank);
+    STATS_SET(&m->stats, peeled, m->solved);
+    STATS_SET(&m->stats, eliminated, m->rank - m->solved);
+    if (determined(m)) {
+        STATS_DETERMINED(&m->stats);
     }
 }
 
-int* xorRow(sparseMatrix *m, int s, int *indices, block *b, size_t indices_len, size_t *new_indices_len) {
-
-    xor_block(b, &m->v[s]);
+int* xorRow(sparseMatrix *m, int s, int *indices, size_t indices_len, block *b, size_t *new_indices_len) {
 
-    int *newIndices = malloc((indices_len + 100) * sizeof(int)); 
-    *new_indices_len = 0;
+    blockXor(b, &m->v[s]);
+    STATS_ADD(&m->stats, rowMerges, 1);
+    STATS_ADD(&m->stats, xorBytes, m->v[s].length);
 
     int *coeffs = m->coeff[s];
     size_t i = 0, j = 0;
-    size_t coeffs_len = 0;
-    
-    while (coeffs[coeffs_len] != -1) {
-        coeffs_len++;
-    }
+    size_t coeffs_len = m->coeffLen[s];
+
+    // 결과는 입력과 겹치지 않는 scratch 버퍼에 씁니다 (최대 numRows개)
+    int *newIndices = indices == m->scratch[0] ? m->scratch[1] : m->scratch[0];
+    *new_indices_len = 0;
 
     while (i < coeffs_len && j < indices_len) {
         int index = indices[j];
@@ -146,45 +182,31 @@ int* xorRow(sparseMatrix *m, int s, int *indices, block *b, size_t indices_len,
     return newIndices;
 }
 
+// 모든 행에 피벗이 있는지 여부. rank를 유지하므로 O(1)입니다.
 bool determined(sparseMatrix* m) {
-    for (int i = 0; i < m->numRows; i++) {
-        if (m->coeff[i] == NULL || m->coeff[i][0] != i) {
-            return false;
-        }
-    }
-    return true;
+    return m->rank == m->numRows;
+}
+
+// 디코딩 진행률 (0.0 ~ 1.0)
+double decodeProgress(sparseMatrix* m) {
+    return m->numRows > 0 ? (double)m->rank / m->numRows : 1.0;
 }
 
-void Reduce(sparseMatrix* m) {
+// 역대입. 아래 행부터 처리하므로 행 i의 꼬리에 있는 인덱스 t > i는 이미
+// out에 풀려 있고, out[i] = v[i] ^ out[t...]를 한 번에 계산합니다.
+// 행렬 자체는 바뀌지 않습니다.
+void Reduce(sparseMatrix* m, symbolMatrix* out) {
+    STATS_TIMER(t0);
+    const uint8_t** srcs = (const uint8_t**)malloc((m->numRows > 0 ? m->numRows : 1) * sizeof(uint8_t*));
     for (int i = m->numRows - 1; i >= 0; i--) {
-        for (int j = 0; j < i; j++) {
-            int* ci = m->coeff[i];
-            int* cj = m->coeff[j];
-            for (int k = 1; k < sizeof(cj) / sizeof(int); k++) {
-                if (cj[k] == ci[0]) {
-                    blockXor(&m->v[j], &m->v[i]);
-                    break;
-                }
-            }
+        int n = 0;
+        srcs[n++] = m->v[i].data;
+        for (int k = 1; k < m->coeffLen[i]; k++) {
+            srcs[n++] = symbolAt(out, m->coeff[i][k]);
         }
-        m->coeff[i] = (int*)realloc(m->coeff[i], sizeof(int));
-        m->coeff[i][0] = i;
+        xorBytesGather(symbolAt(out, i), srcs, n, out->symbolSize);
+        STATS_ADD(&m->stats, xorBytes, (size_t)n * out->symbolSize);
     }
+    free(srcs);
+    STATS_ELAPSED(&m->stats, backsubNanos, t0);
 }
-
-uint8_t* Reconstruct(sparseMatrix* m, int totalLength, int lenLong, int lenShort, int numLong, int numShort) {
-    uint8_t* out = (uint8_t*)malloc(totalLength * sizeof(uint8_t));
-    int offset = 0;
-    
-    for (int i = 0; i < numLong; i++) {
-        memcpy(out + offset, m->v[i].data, lenLong);
-        offset += lenLong;
-    }
-
-    for (int i = numLong; i < numLong + numShort; i++) {
-        memcpy(out + offset, m->v[i].data, lenShort);
-        offset += lenShort;
-    }
-
-    return out;
-}
\ No newline at end of file
@@ -4,32 +4,159 @@
 #include <time.h>
 #include "fountain.h"
 #include "raptor.h"
+#include "pool.h"
 
 // Raptor 코덱 생성
 RaptorCodec* NewRaptorCodec(int symbols, int alignment) {
     RaptorCodec* codec = (RaptorCodec*)malloc(sizeof(RaptorCodec));
-    codec->symbols = symbols;
-    codec->alignment = alignment;
+    codec->NumSourceSymbols = symbols;
+    codec->SymbolAlignmentSize = alignment;
+    raptor_params_init(&codec->params, symbols);
     return codec;
 }
 
-// 메시지를 LT 블록으로 인코딩합니다.
-LTBlock* EncodeLTBlocks(uint8_t* message, int messageLen, int64_t* ids, int numIds, RaptorCodec* codec) {
+// 여러 스레드가 나눠 인코딩하는 블록 묶음
+typedef struct {
+    const raptor_params* params;
+    const symbolMatrix* intermediate;
+    const int64_t* ids;     // NULL이면 firstId부터 연속된 ID
+    int64_t firstId;
+    uint8_t* output;
+} raptorBatch;
+
+// [begin, end) 블록을 인코딩합니다. 블록은 ID로만 정해지고 자기 자리에 쓰이므로
+// 어떻게 나눠 처리해도 결과가 같습니다.
+static void encodeBatchRange(void* arg, int begin, int end) {
+    raptorBatch* batch = (raptorBatch*)arg;
+    size_t size = batch->intermediate->symbolSize;
+    for (int i = begin; i < end; i++) {
+        int64_t id = batch->ids ? batch->ids[i] : batch->firstId + i;
+        lt_encode(batch->params, (uint16_t)id, batch->intermediate, batch->output + i * size);
+    }
+}
+
+// ID가 ESI 범위(0..RAPTOR_MAX_ESI) 안에 있는지. 16비트로 자르면 다른 기호가
+// 되므로 범위를 벗어난 ID는 인코딩하지 않습니다.
+static bool validEsi(int64_t id) {
+    return id >= 0 && id <= RAPTOR_MAX_ESI;
+}
+
+static bool validEsis(const int64_t* ids, int numIds) {
+    for (int i = 0; i < numIds; i++) {
+        if (!validEsi(ids[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 블록 묶음을 pool의 스레드에 나눠 인코딩합니다 (pool이 NULL이면 호출 스레드).
+static void encodeBatch(const raptor_params* params, const symbolMatrix* intermediate, const int64_t* ids, int64_t firstId, int numIds, uint8_t* output, threadPool* pool) {
+    raptorBatch batch = {params, intermediate, ids, firstId, output};
+    int grain = numIds / (threadPoolSize(pool) * 8);
+    threadPoolFor(pool, numIds, grain > 0 ? grain : 1, encodeBatchRange, &batch);
+}
+
+// 메시지를 인코딩해 ids의 블록을 output에 이어서 씁니다. output은 numIds개의
+// 블록(각 ceil(messageLen / K) 바이트)을 담을 수 있어야 하고, 블록 i는
+// output + i * 블록 길이에서 시작합니다. pool이 NULL이면 호출 스레드에서 인코딩합니다.
+// 블록 길이를 반환하고, ESI 범위를 벗어난 ID가 있거나 중간 기호를 풀지 못하면
+// -1을 반환합니다.
+int EncodeRaptorBlocksInto(const uint8_t* message, int messageLen, const int64_t* ids, int numIds, RaptorCodec* codec, uint8_t* output, threadPool* pool) {
+    if (!validEsis(ids, numIds)) {
+        return -1;
+    }
+    symbolMatrix* intermediate = generate_intermediate_blocks(&codec->params, message, messageLen, codec->SymbolAlignmentSize);
+    if (intermediate == NULL) {
+        return -1;
+    }
+
+    encodeBatch(&codec->params, intermediate, ids, 0, numIds, output, pool);
+
+    int size = intermediate->symbolSize;
+    freeSymbolMatrix(intermediate);
+    return size;
+}
+
+// 메시지를 LT 블록으로 인코딩합니다. 블록마다 따로 할당합니다. ESI 범위를 벗어난
+// ID가 있거나 중간 기호를 풀지 못하면 NULL을 반환합니다.
+LTBlock* EncodeRaptorBlocks(const uint8_t* message, int messageLen, int64_t* ids, int numIds, RaptorCodec* codec) {
+    if (!validEsis(ids, numIds)) {
+        return NULL;
+    }
+    symbolMatrix* intermediate = generate_intermediate_blocks(&codec->params, message, messageLen, codec->SymbolAlignmentSize);
+    if (intermediate == NULL) {
+        return NULL;
+    }
     LTBlock* encodedBlocks = (LTBlock*)malloc(numIds * sizeof(LTBlock));
-    
-    // 여기에 실제 인코딩 논리를 구현해야 합니다. 임시로 데이터를 직접 복사합니다.
+
     for (int i = 0; i < numIds; i++) {
-        encodedBlocks[i].data = (uint8_t*)malloc(messageLen * sizeof(uint8_t));
-        memcpy(encodedBlocks[i].data, message, messageLen);
-        encodedBlocks[i].length = messageLen;
-        encodedBlocks[i].id = (int)ids[i];
+        encodedBlocks[i].data = (uint8_t*)malloc(intermediate->symbolSize);
+        encodedBlocks[i].length = intermediate->symbolSize;
+        encodedBlocks[i].blockCode = ids[i];
+        lt_encode(&codec->params, (uint16_t)ids[i], intermediate, encodedBlocks[i].data);
     }
-    
+
+    freeSymbolMatrix(intermediate);
     return encodedBlocks;
 }
 
+// 스트리밍 인코더 생성. 중간 기호를 한 번만 계산해 FreeRaptorEncoder까지 들고
+// 있으므로, 수신 측의 응답을 기다리며 복구 기호를 계속 만들어도 메시지를 다시
+// 나누지 않습니다. 코덱은 인코더보다 오래 살아야 하고 메시지는 바로 해제해도 됩니다.
+// 중간 기호를 풀지 못하면 NULL을 반환합니다.
+RaptorEncoder* NewRaptorEncoder(const RaptorCodec* codec, const uint8_t* message, int messageLen) {
+    symbolMatrix* intermediate = generate_intermediate_blocks(&codec->params, message, messageLen, codec->SymbolAlignmentSize);
+    if (intermediate == NULL) {
+        return NULL;
+    }
+    RaptorEncoder* encoder = (RaptorEncoder*)malloc(sizeof(RaptorEncoder));
+    encoder->codec = codec;
+    encoder->intermediate = intermediate;
+    encoder->nextId = 0;
+    return encoder;
+}
+
+// 인코더가 만드는 기호 하나의 바이트 수
+int RaptorEncoderSymbolSize(const RaptorEncoder* encoder) {
+    return encoder->intermediate->symbolSize;
+}
+
+// 다음 기호 최대 n개를 output에 이어서 쓰고 그 ID를 ids에 씁니다. ID는 0부터
+// 차례로 나가며, 쓴 기호 수를 돌려줍니다. RFC 5053의 ESI는 16비트라 서로 다른
+// 기호는 RAPTOR_MAX_ESI + 1개뿐이고, 다 쓰면 0을 돌려줍니다.
+int NextRaptorSymbols(RaptorEncoder* encoder, int n, int64_t* ids, uint8_t* output, threadPool* pool) {
+    int64_t left = RAPTOR_MAX_ESI + 1 - encoder->nextId;
+    if (n > left) {
+        n = (int)left;
+    }
+    for (int i = 0; i < n; i++) {
+        ids[i] = encoder->nextId + i;
+    }
+    encodeBatch(&encoder->codec->params, encoder->intermediate, NULL, encoder->nextId, n, output, pool);
+    encoder->nextId += n;
+    return n;
+}
+
+// 인코더 위치를 바꾸지 않고 ids의 기호를 output에 씁니다 (재전송 요청 등).
+// ESI 범위를 벗어난 ID가 있으면 아무것도 쓰지 않고 false를 반환합니다.
+bool EncodeRaptorSymbolsAt(RaptorEncoder* encoder, const int64_t* ids, int numIds, uint8_t* output, threadPool* pool) {
+    if (!validEsis(ids, numIds)) {
+        return false;
+    }
+    encodeBatch(&encoder->codec->params, encoder->intermediate, ids, 0, numIds, output, pool);
+    return true;
+}
+
+void FreeRaptorEncoder(RaptorEncoder* encoder) {
+    if (encoder != NULL) {
+        freeSymbolMatrix(encoder->intermediate);
+        free(encoder);
+    }
+}
+
 // 메시지를 인코딩합니다.
-LTBlock* Encode(uint8_t* message, int messageLen, int symbols, int alignment, int encBlocks, int* outSize) {
+LTBlock* Encode(const uint8_t* message, int messageLen, int symbols, int alignment, int encBlocks, int* outSize) {
     RaptorCodec* codec = NewRaptorCodec(symbols, alignment);
     int64_t* ids = (int64_t*)malloc(encBlocks * sizeof(int64_t));
 
@@ -41,43 +168,64 @@ LTBlock* Encode(uint8_t* message, int messageLen, int symbols, int alignment, in
         ids[i] = rand() % 60000;
     }
 
-    // 메시지 복사
-    uint8_t* messageCopy = (uint8_t*)malloc(messageLen * sizeof(uint8_t));
-    memcpy(messageCopy, message, messageLen);
-
-    // LT 블록 인코딩
-    LTBlock* encodedBlocks = EncodeLTBlocks(messageCopy, messageLen, ids, encBlocks, codec);
+    // LT 블록 인코딩. 인코더는 메시지를 읽기만 하므로 복사하지 않습니다.
+    LTBlock* encodedBlocks = EncodeRaptorBlocks(message, messageLen, ids, encBlocks, codec);
 
     // 결과 설정
-    *outSize = encBlocks;
+    *outSize = encodedBlocks ? encBlocks : 0;
 
     // 메모리 해제
-    free(messageCopy);
     free(ids);
 
     return encodedBlocks;
 }
 
-// 메시지를 디코딩합니다.
-uint8_t* Decode(RaptorCodec* codec, LTBlock* encodedSymbols, int numSymbols, int messageSize, int* decodedSymbolIndex, int* outSize, uint8_t hash[32]) {
-    raptorDecoder* decoder = newRaptorDecoder(codec, messageSize);
-    uint8_t* output = NULL;
+// 호출자 버퍼 output으로 메시지를 디코딩합니다. output은
+// symbolBufferSize(messageSize, 원본 기호 수) 바이트 이상이어야 하며, 성공하면
+// 앞쪽 messageSize 바이트가 메시지입니다. 방정식 수가 L에 도달하기 전에는 풀이를
+// 시도하지 않고, 풀이에 성공하는 순간 남은 기호는 읽지 않고 멈춥니다.
+// 풀이는 매번 처음부터 다시 하므로, 실패하면 기호 max(1, K/100)개를 더 받은
+// 뒤에야 다시 시도합니다. 원본 기호가 모두 모이면 풀이 없이 복사만 하므로 바로 시도합니다.
+// ESI 범위를 벗어난 ID의 기호는 다른 기호로 잘못 읽히지 않도록 버립니다.
+bool DecodeInto(RaptorCodec* codec, LTBlock* encodedSymbols, int numSymbols, int messageSize, uint8_t* output, int* decodedSymbolIndex) {
+    raptor_decoder* decoder = (raptor_decoder*)new_decoder(codec, messageSize);
+    int K = decoder->params.K;
+    int retryStep = K / 100 > 1 ? K / 100 : 1;
+    int nextTry = 0;
+    bool ok = false;
 
+    *decodedSymbolIndex = -1;
     for (int i = 0; i < numSymbols; i++) {
-        AddBlocksToDecoder(decoder, &encodedSymbols[i], 1);
-        if (decoder->matrix.determined()) {
-            output = decoder->Decode(outSize);
+        if (!validEsi(encodedSymbols[i].blockCode)) {
+            continue;
+        }
+        uint16_t esi = (uint16_t)encodedSymbols[i].blockCode;
+        if (!add_blocks(decoder, &esi, encodedSymbols[i].data, 1)) {
+            continue;
+        }
+        if (i < nextTry && decoder->num_source < K) {
+            continue;
+        }
+        if (decode_into(decoder, output)) {
             *decodedSymbolIndex = i + 1;
+            ok = true;
             break;
         }
+        nextTry = i + retryStep;
     }
 
-    if (!output) {
-        *decodedSymbolIndex = -1;
-    }
+    destroy_raptor_decoder(decoder);
+    return ok;
+}
 
-    // 디코더 해제 (사용자 정의 함수 필요)
-    freeRaptorDecoder(decoder);
+// 메시지를 디코딩합니다.
+uint8_t* Decode(RaptorCodec* codec, LTBlock* encodedSymbols, int numSymbols, int messageSize, int* decodedSymbolIndex, int* outSize, uint8_t hash[32]) {
+    uint8_t* output = (uint8_t*)malloc(symbolBufferSize(messageSize, codec->NumSourceSymbols));
+    if (!DecodeInto(codec, encodedSymbols, numSymbols, messageSize, output, decodedSymbolIndex)) {
+        free(output);
+        return NULL;
+    }
 
+    *outSize = messageSize;
     return output;
-}
\ No newline at end of file
+}
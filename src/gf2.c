@@ -0,0 +1,99 @@
+#include <stdlib.h>
+#include <string.h>
+#include "gf2.h"
+#include "xor.h"
+
+// 행렬 생성. 모든 계수는 0으로 시작합니다.
+gf2Matrix* newGF2Matrix(int numRows, int numCols) {
+    gf2Matrix* m = (gf2Matrix*)malloc(sizeof(gf2Matrix));
+    m->numRows = numRows;
+    m->numCols = numCols;
+    m->stride = (numCols + 63) / 64;
+    m->words = (uint64_t*)calloc((size_t)numRows * m->stride + 1, sizeof(uint64_t));
+    m->rows = (uint64_t**)malloc((numRows > 0 ? numRows : 1) * sizeof(uint64_t*));
+    for (int i = 0; i < numRows; i++) {
+        m->rows[i] = m->words + (size_t)i * m->stride;
+    }
+    return m;
+}
+
+void freeGF2Matrix(gf2Matrix* m) {
+    if (m != NULL) {
+        free(m->words);
+        free(m->rows);
+        free(m);
+    }
+}
+
+void gf2Set(gf2Matrix* m, int row, int col) {
+    m->rows[row][col >> 6] |= 1ULL << (col & 63);
+}
+
+bool gf2Get(const gf2Matrix* m, int row, int col) {
+    return (m->rows[row][col >> 6] >> (col & 63)) & 1;
+}
+
+void gf2SwapRows(gf2Matrix* m, int a, int b) {
+    uint64_t* temp = m->rows[a];
+    m->rows[a] = m->rows[b];
+    m->rows[b] = temp;
+}
+
+// dst 행에 src 행을 XOR 합니다. fromCol 이전의 열이 src에서 모두 0이면
+// 그 앞 워드는 건너뜁니다.
+void gf2XorRows(gf2Matrix* m, int dst, int src, int fromCol) {
+    int w = fromCol >> 6;
+    xorBytes((uint8_t*)(m->rows[dst] + w), (const uint8_t*)(m->rows[src] + w), (size_t)(m->stride - w) * sizeof(uint64_t));
+}
+
+// 열 수가 같은 다른 행렬의 행을 XOR 합니다.
+void gf2XorRowInto(gf2Matrix* dst, int dstRow, const gf2Matrix* src, int srcRow) {
+    xorBytes((uint8_t*)dst->rows[dstRow], (const uint8_t*)src->rows[srcRow], (size_t)dst->stride * sizeof(uint64_t));
+}
+
+// 행에서 1인 계수의 수
+int gf2RowWeight(const gf2Matrix* m, int row) {
+    int weight = 0;
+    for (int w = 0; w < m->stride; w++) {
+        weight += __builtin_popcountll(m->rows[row][w]);
+    }
+    return weight;
+}
+
+// fromCol 이상에서 처음으로 1인 열. 없으면 -1을 반환합니다.
+int gf2NextSet(const gf2Matrix* m, int row, int fromCol) {
+    if (fromCol >= m->numCols) {
+        return -1;
+    }
+    int w = fromCol >> 6;
+    uint64_t word = m->rows[row][w] & (~0ULL << (fromCol & 63));
+    while (word == 0) {
+        if (++w >= m->stride) {
+            return -1;
+        }
+        word = m->rows[row][w];
+    }
+    int col = (w << 6) + __builtin_ctzll(word);
+    return col < m->numCols ? col : -1;
+}
+
+// fromRow 이상의 행 가운데 col 열이 1인 행을 찾습니다. 후보가 여럿이면
+// 채움(fill-in)을 줄이도록 가중치가 가장 작은 행을 고릅니다. 없으면 -1.
+int gf2FindPivot(const gf2Matrix* m, int col, int fromRow) {
+    int w = col >> 6;
+    uint64_t bit = 1ULL << (col & 63);
+    int pivot = -1, best = 0;
+    for (int r = fromRow; r < m->numRows; r++) {
+        if (m->rows[r][w] & bit) {
+            int weight = gf2RowWeight(m, r);
+            if (pivot < 0 || weight < best) {
+                pivot = r;
+                best = weight;
+                if (weight == 1) {
+                    break;
+                }
+            }
+        }
+    }
+    return pivot;
+}
@@ -0,0 +1,181 @@
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include "../include/gf256.h"
+#include "../include/xor.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define GF256_X86 1
+#endif
+
+// alpha^i. 곱셈에서 로그 두 개의 합(최대 508)을 나머지 없이 찾도록 두 바퀴를 둡니다.
+const uint8_t gf256ExpTable[510] = {
+    1, 2, 4, 8, 16, 32, 64, 128, 29, 58, 116, 232, 205, 135, 19, 38,
+    76, 152, 45, 90, 180, 117, 234, 201, 143, 3, 6, 12, 24, 48, 96, 192,
+    157, 39, 78, 156, 37, 74, 148, 53, 106, 212, 181, 119, 238, 193, 159, 35,
+    70, 140, 5, 10, 20, 40, 80, 160, 93, 186, 105, 210, 185, 111, 222, 161,
+    95, 190, 97, 194, 153, 47, 94, 188, 101, 202, 137, 15, 30, 60, 120, 240,
+    253, 231, 211, 187, 107, 214, 177, 127, 254, 225, 223, 163, 91, 182, 113, 226,
+    217, 175, 67, 134, 17, 34, 68, 136, 13, 26, 52, 104, 208, 189, 103, 206,
+    129, 31, 62, 124, 248, 237, 199, 147, 59, 118, 236, 197, 151, 51, 102, 204,
+    133, 23, 46, 92, 184, 109, 218, 169, 79, 158, 33, 66, 132, 21, 42, 84,
+    168, 77, 154, 41, 82, 164, 85, 170, 73, 146, 57, 114, 228, 213, 183, 115,
+    230, 209, 191, 99, 198, 145, 63, 126, 252, 229, 215, 179, 123, 246, 241, 255,
+    227, 219, 171, 75, 150, 49, 98, 196, 149, 55, 110, 220, 165, 87, 174, 65,
+    130, 25, 50, 100, 200, 141, 7, 14, 28, 56, 112, 224, 221, 167, 83, 166,
+    81, 162, 89, 178, 121, 242, 249, 239, 195, 155, 43, 86, 172, 69, 138, 9,
+    18, 36, 72, 144, 61, 122, 244, 245, 247, 243, 251, 235, 203, 139, 11, 22,
+    44, 88, 176, 125, 250, 233, 207, 131, 27, 54, 108, 216, 173, 71, 142, 1,
+    2, 4, 8, 16, 32, 64, 128, 29, 58, 116, 232, 205, 135, 19, 38, 76,
+    152, 45, 90, 180, 117, 234, 201, 143, 3, 6, 12, 24, 48, 96, 192, 157,
+    39, 78, 156, 37, 74, 148, 53, 106, 212, 181, 119, 238, 193, 159, 35, 70,
+    140, 5, 10, 20, 40, 80, 160, 93, 186, 105, 210, 185, 111, 222, 161, 95,
+    190, 97, 194, 153, 47, 94, 188, 101, 202, 137, 15, 30, 60, 120, 240, 253,
+    231, 211, 187, 107, 214, 177, 127, 254, 225, 223, 163, 91, 182, 113, 226, 217,
+    175, 67, 134, 17, 34, 68, 136, 13, 26, 52, 104, 208, 189, 103, 206, 129,
+    31, 62, 124, 248, 237, 199, 147, 59, 118, 236, 197, 151, 51, 102, 204, 133,
+    23, 46, 92, 184, 109, 218, 169, 79, 158, 33, 66, 132, 21, 42, 84, 168,
+    77, 154, 41, 82, 164, 85, 170, 73, 146, 57, 114, 228, 213, 183, 115, 230,
+    209, 191, 99, 198, 145, 63, 126, 252, 229, 215, 179, 123, 246, 241, 255, 227,
+    219, 171, 75, 150, 49, 98, 196, 149, 55, 110, 220, 165, 87, 174, 65, 130,
+    25, 50, 100, 200, 141, 7, 14, 28, 56, 112, 224, 221, 167, 83, 166, 81,
+    162, 89, 178, 121, 242, 249, 239, 195, 155, 43, 86, 172, 69, 138, 9, 18,
+    36, 72, 144, 61, 122, 244, 245, 247, 243, 251, 235, 203, 139, 11, 22, 44,
+    88, 176, 125, 250, 233, 207, 131, 27, 54, 108, 216, 173, 71, 142};
+
+const uint8_t gf256LogTable[256] = {
+    0, 0, 1, 25, 2, 50, 26, 198, 3, 223, 51, 238, 27, 104, 199, 75,
+    4, 100, 224, 14, 52, 141, 239, 129, 28, 193, 105, 248, 200, 8, 76, 113,
+    5, 138, 101, 47, 225, 36, 15, 33, 53, 147, 142, 218, 240, 18, 130, 69,
+    29, 181, 194, 125, 106, 39, 249, 185, 201, 154, 9, 120, 77, 228, 114, 166,
+    6, 191, 139, 98, 102, 221, 48, 253, 226, 152, 37, 179, 16, 145, 34, 136,
+    54, 208, 148, 206, 143, 150, 219, 189, 241, 210, 19, 92, 131, 56, 70, 64,
+    30, 66, 182, 163, 195, 72, 126, 110, 107, 58, 40, 84, 250, 133, 186, 61,
+    202, 94, 155, 159, 10, 21, 121, 43, 78, 212, 229, 172, 115, 243, 167, 87,
+    7, 112, 192, 247, 140, 128, 99, 13, 103, 74, 222, 237, 49, 197, 254, 24,
+    227, 165, 153, 119, 38, 184, 180, 124, 17, 68, 146, 217, 35, 32, 137, 46,
+    55, 63, 209, 91, 149, 188, 207, 205, 144, 135, 151, 178, 220, 252, 190, 97,
+    242, 86, 211, 171, 20, 42, 93, 158, 132, 60, 57, 83, 71, 109, 65, 162,
+    31, 45, 67, 216, 183, 123, 164, 118, 196, 23, 73, 236, 127, 12, 111, 246,
+    108, 161, 59, 82, 41, 157, 85, 170, 251, 96, 134, 177, 187, 204, 62, 90,
+    203, 89, 95, 176, 156, 169, 160, 81, 11, 245, 22, 235, 122, 117, 44, 215,
+    79, 174, 213, 233, 230, 231, 173, 232, 116, 214, 244, 234, 168, 80, 88, 175};
+
+// 상수 c에 대한 니블 곱셈표: c * x = nibbleLo[c][x & 15] ^ nibbleHi[c][x >> 4]
+static uint8_t nibbleLo[256][16] __attribute__((aligned(16)));
+static uint8_t nibbleHi[256][16] __attribute__((aligned(16)));
+
+// accumulate가 true이면 dst ^= c * src, false이면 dst = c * src (src == dst 허용)
+typedef void (*gf256Kernel)(uint8_t*, const uint8_t*, uint8_t, size_t, bool);
+
+// 표를 쓰는 바이트 단위 루프 [i, length). 벡터 커널의 나머지도 처리합니다.
+static void mulRange(uint8_t* dst, const uint8_t* src, uint8_t c, size_t i, size_t length, bool accumulate) {
+    const uint8_t* lo = nibbleLo[c];
+    const uint8_t* hi = nibbleHi[c];
+    for (; i < length; i++) {
+        uint8_t v = lo[src[i] & 15] ^ hi[src[i] >> 4];
+        dst[i] = accumulate ? dst[i] ^ v : v;
+    }
+}
+
+static void gf256Kernel_Table(uint8_t* dst, const uint8_t* src, uint8_t c, size_t length, bool accumulate) {
+    mulRange(dst, src, c, 0, length, accumulate);
+}
+
+#ifdef GF256_X86
+
+// PSHUFB로 16바이트의 하위/상위 니블을 한 번에 표에서 찾습니다.
+__attribute__((target("ssse3")))
+static void gf256Kernel_SSSE3(uint8_t* dst, const uint8_t* src, uint8_t c, size_t length, bool accumulate) {
+    const __m128i lo = _mm_load_si128((const __m128i*)nibbleLo[c]);
+    const __m128i hi = _mm_load_si128((const __m128i*)nibbleHi[c]);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i p = _mm_xor_si128(_mm_shuffle_epi8(lo, _mm_and_si128(s, mask)),
+                                  _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi64(s, 4), mask)));
+        if (accumulate) {
+            p = _mm_xor_si128(p, _mm_loadu_si128((const __m128i*)(dst + i)));
+        }
+        _mm_storeu_si128((__m128i*)(dst + i), p);
+    }
+    mulRange(dst, src, c, i, length, accumulate);
+}
+
+__attribute__((target("avx2")))
+static void gf256Kernel_AVX2(uint8_t* dst, const uint8_t* src, uint8_t c, size_t length, bool accumulate) {
+    const __m256i lo = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)nibbleLo[c]));
+    const __m256i hi = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)nibbleHi[c]));
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i p = _mm256_xor_si256(_mm256_shuffle_epi8(lo, _mm256_and_si256(s, mask)),
+                                     _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi64(s, 4), mask)));
+        if (accumulate) {
+            p = _mm256_xor_si256(p, _mm256_loadu_si256((const __m256i*)(dst + i)));
+        }
+        _mm256_storeu_si256((__m256i*)(dst + i), p);
+    }
+    mulRange(dst, src, c, i, length, accumulate);
+}
+
+#endif // GF256_X86
+
+static gf256Kernel selectedKernel = gf256Kernel_Table;
+static const char* selectedKernelName = "table";
+static pthread_once_t kernelOnce = PTHREAD_ONCE_INIT;
+
+// 니블 표를 채우고 실행 중인 CPU에서 지원하는 가장 넓은 커널을 선택합니다.
+static void selectKernel(void) {
+    for (int c = 0; c < 256; c++) {
+        for (int x = 0; x < 16; x++) {
+            nibbleLo[c][x] = gf256Mul((uint8_t)c, (uint8_t)x);
+            nibbleHi[c][x] = gf256Mul((uint8_t)c, (uint8_t)(x << 4));
+        }
+    }
+#ifdef GF256_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        selectedKernel = gf256Kernel_AVX2;
+        selectedKernelName = "avx2";
+    } else if (__builtin_cpu_supports("ssse3")) {
+        selectedKernel = gf256Kernel_SSSE3;
+        selectedKernelName = "ssse3";
+    }
+#endif
+}
+
+static gf256Kernel kernel(void) {
+    pthread_once(&kernelOnce, selectKernel);
+    return selectedKernel;
+}
+
+void gf256MulAdd(uint8_t* dst, const uint8_t* src, uint8_t c, size_t length) {
+    if (c == 0) {
+        return;
+    }
+    if (c == 1) {
+        xorBytes(dst, src, length);
+        return;
+    }
+    kernel()(dst, src, c, length, true);
+}
+
+void gf256Scale(uint8_t* dst, uint8_t c, size_t length) {
+    if (c == 1) {
+        return;
+    }
+    if (c == 0) {
+        memset(dst, 0, length);
+        return;
+    }
+    kernel()(dst, dst, c, length, false);
+}
+
+const char* gf256KernelName(void) {
+    pthread_once(&kernelOnce, selectKernel);
+    return selectedKernelName;
+}
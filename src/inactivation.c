@@ -0,0 +1,509 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "inactivation.h"
+#include "gf2.h"
+#include "gf256.h"
+#include "xor.h"
+
+#define COL_ACTIVE 0
+#define COL_PIVOTED 1
+#define COL_INACTIVE 2
+
+// 디코더 생성
+inactivation_decoder* new_inactivation_decoder(int num_cols, int symbol_size) {
+    inactivation_decoder* dec = (inactivation_decoder*)calloc(1, sizeof(inactivation_decoder));
+    dec->num_cols = num_cols;
+    dec->symbol_size = symbol_size;
+    arenaInit(&dec->mem, symbol_size, 0);
+    dec->stats.numCols = num_cols;
+    return dec;
+}
+
+// 디코더 해제
+void destroy_inactivation_decoder(inactivation_decoder* dec) {
+    if (dec) {
+        arenaFree(&dec->mem);
+        free(dec->row_indices);
+        free(dec->row_degree);
+        free(dec->row_values);
+        free(dec->dense_coeffs);
+        free(dec->dense_values);
+        free(dec);
+    }
+}
+
+// 방정식을 담는 데 쓰는 바이트 수 (풀이 중의 임시 버퍼 제외)
+static inline size_t decoder_bytes(const inactivation_decoder* dec) {
+    return dec->mem.reserved + (size_t)dec->cap_rows * (2 * sizeof(void*) + sizeof(int)) +
+        (size_t)dec->cap_dense * 2 * sizeof(void*);
+}
+
+static int compare_int(const void* a, const void* b) {
+    return (*(const int*)a > *(const int*)b) - (*(const int*)a < *(const int*)b);
+}
+
+// 방정식 추가. 같은 열이 두 번 나오면 GF(2)에서 상쇄되므로 제거합니다.
+// value가 NULL이면 값이 0인 제약 방정식입니다.
+void inactivation_add_row(inactivation_decoder* dec, const int* indices, int num_indices, const uint8_t* value) {
+    if (dec->num_rows == dec->cap_rows) {
+        dec->cap_rows = dec->cap_rows ? 2 * dec->cap_rows : dec->num_cols + 16;
+        dec->row_indices = (int**)realloc(dec->row_indices, dec->cap_rows * sizeof(int*));
+        dec->row_degree = (int*)realloc(dec->row_degree, dec->cap_rows * sizeof(int));
+        dec->row_values = (uint8_t**)realloc(dec->row_values, dec->cap_rows * sizeof(uint8_t*));
+    }
+
+    int* row = (int*)arenaAlloc(&dec->mem, num_indices * sizeof(int));
+    memcpy(row, indices, num_indices * sizeof(int));
+    qsort(row, num_indices, sizeof(int), compare_int);
+    int degree = 0;
+    for (int i = 0; i < num_indices; i++) {
+        if (i + 1 < num_indices && row[i] == row[i + 1]) {
+            i++;
+        } else {
+            row[degree++] = row[i];
+        }
+    }
+
+    uint8_t* v = NULL;
+    if (value) {
+        v = arenaSymbol(&dec->mem);
+        memcpy(v, value, dec->symbol_size);
+    }
+
+    dec->row_indices[dec->num_rows] = row;
+    dec->row_degree[dec->num_rows] = degree;
+    dec->row_values[dec->num_rows] = v;
+    dec->num_rows++;
+    STATS_ADD(&dec->stats, symbolsAdded, value ? 1 : 0);
+    STATS_MAX(&dec->stats, peakBytes, decoder_bytes(dec));
+}
+
+// GF(256) 밀집 행 추가. coeffs는 num_cols개 열의 계수이고 value가 NULL이면 값이 0입니다.
+void inactivation_add_dense_row(inactivation_decoder* dec, const uint8_t* coeffs, const uint8_t* value) {
+    if (dec->num_dense == dec->cap_dense) {
+        dec->cap_dense = dec->cap_dense ? 2 * dec->cap_dense : 16;
+        dec->dense_coeffs = (uint8_t**)realloc(dec->dense_coeffs, dec->cap_dense * sizeof(uint8_t*));
+        dec->dense_values = (uint8_t**)realloc(dec->dense_values, dec->cap_dense * sizeof(uint8_t*));
+    }
+    uint8_t* c = (uint8_t*)arenaAlloc(&dec->mem, dec->num_cols);
+    memcpy(c, coeffs, dec->num_cols);
+    uint8_t* v = NULL;
+    if (value) {
+        v = arenaSymbol(&dec->mem);
+        memcpy(v, value, dec->symbol_size);
+    }
+    dec->dense_coeffs[dec->num_dense] = c;
+    dec->dense_values[dec->num_dense] = v;
+    dec->num_dense++;
+}
+
+// 무게가 b인 그레이 코드를 순서대로 length개 만듭니다.
+static void gray_sequence(int length, int b, uint32_t* sequence) {
+    int i = 0;
+    for (uint32_t x = 0; i < length; x++) {
+        uint32_t g = x ^ (x >> 1);
+        if (__builtin_popcount(g) == b) {
+            sequence[i++] = g;
+        }
+    }
+}
+
+// LDPC 기호 S개와 Half 기호 H개에 대한 제약 방정식을 추가합니다 (RFC 5053 5.4.2.3).
+void inactivation_add_constraints(inactivation_decoder* dec, int k, int s, int h) {
+    int** rows = (int**)malloc((s + h) * sizeof(int*));
+    int* lens = (int*)calloc(s + h, sizeof(int));
+    for (int i = 0; i < s + h; i++) {
+        rows[i] = (int*)malloc((3 * k / s + 4 + (i >= s ? k + s : 0)) * sizeof(int));
+    }
+
+    for (int i = 0; i < k; i++) {
+        int a = 1 + (i / s) % (s - 1);
+        int b = i % s;
+        for (int j = 0; j < 3; j++) {
+            rows[b][lens[b]++] = i;
+            b = (b + a) % s;
+        }
+    }
+    for (int i = 0; i < s; i++) {
+        rows[i][lens[i]++] = k + i;
+    }
+
+    int hprime = (int)ceil((double)h / 2);
+    uint32_t* m = (uint32_t*)malloc((k + s) * sizeof(uint32_t));
+    gray_sequence(k + s, hprime, m);
+    for (int i = 0; i < h; i++) {
+        int* row = rows[s + i];
+        for (int j = 0; j < k + s; j++) {
+            if ((m[j] >> i) & 1) {
+                row[lens[s + i]++] = j;
+            }
+        }
+        row[lens[s + i]++] = k + s + i;
+    }
+
+    for (int i = 0; i < s + h; i++) {
+        inactivation_add_row(dec, rows[i], lens[i], NULL);
+        free(rows[i]);
+    }
+    free(m);
+    free(rows);
+    free(lens);
+}
+
+// 풀이 중 열 c를 결정된 것으로 표시하고, c를 포함한 행의 활성 차수를 줄입니다.
+// 활성 차수가 1이 된 행은 ripple에 넣습니다.
+static void resolve_column(int c, int state, int* col_state, const int* adj_start, const int* adj,
+                           const bool* used, int* active_degree, int* ripple, int* ripple_tail) {
+    col_state[c] = state;
+    for (int i = adj_start[c]; i < adj_start[c + 1]; i++) {
+        int r = adj[i];
+        if (!used[r] && --active_degree[r] == 1) {
+            ripple[(*ripple_tail)++] = r;
+        }
+    }
+}
+
+// 밀집 시스템 a (rows x cols, GF(2))를 소거합니다. 성공하면 rhs[c]가 c번째 비활성
+// 열의 값입니다. 피벗을 찾은 열의 수(랭크)를 돌려주며, 피벗이 없는 열을 만나면
+// 거기서 멈추므로 모든 열이 풀렸으면 cols와 같습니다.
+static int reduce_gf2(gf2Matrix* a, uint8_t** rhs, size_t ss, decoderStats* stats) {
+    for (int c = 0; c < a->numCols; c++) {
+        int pivot = gf2FindPivot(a, c, c);
+        if (pivot < 0) {
+            return c;
+        }
+        if (pivot != c) {
+            gf2SwapRows(a, c, pivot);
+            uint8_t* temp = rhs[c];
+            rhs[c] = rhs[pivot];
+            rhs[pivot] = temp;
+        }
+        for (int r = 0; r < a->numRows; r++) {
+            if (r != c && gf2Get(a, r, c)) {
+                gf2XorRows(a, r, c, c);
+                xorBytes(rhs[r], rhs[c], ss);
+                STATS_ADD(stats, rowMerges, 1);
+                STATS_ADD(stats, xorBytes, ss);
+            }
+        }
+    }
+    return a->numCols;
+}
+
+// reduce_gf2의 GF(256) 판. m은 행마다 cols 바이트의 계수이고, 피벗 행을 피벗이 1이
+// 되도록 나눈 뒤 다른 행에서 곱해 뺍니다.
+static int reduce_gf256(uint8_t** m, int rows, int cols, uint8_t** rhs, size_t ss, decoderStats* stats) {
+    for (int c = 0; c < cols; c++) {
+        int pivot = -1;
+        for (int r = c; r < rows && pivot < 0; r++) {
+            if (m[r][c] != 0) {
+                pivot = r;
+            }
+        }
+        if (pivot < 0) {
+            return c;
+        }
+        if (pivot != c) {
+            uint8_t* temp = m[c];
+            m[c] = m[pivot];
+            m[pivot] = temp;
+            temp = rhs[c];
+            rhs[c] = rhs[pivot];
+            rhs[pivot] = temp;
+        }
+        uint8_t inv = gf256Inv(m[c][c]);
+        gf256Scale(m[c] + c, inv, cols - c);
+        gf256Scale(rhs[c], inv, ss);
+        STATS_ADD(stats, xorBytes, ss);
+        for (int r = 0; r < rows; r++) {
+            uint8_t beta = m[r][c];
+            if (r != c && beta != 0) {
+                gf256MulAdd(m[r] + c, m[c] + c, beta, cols - c);
+                gf256MulAdd(rhs[r], rhs[c], beta, ss);
+                STATS_ADD(stats, rowMerges, 1);
+                STATS_ADD(stats, xorBytes, ss);
+            }
+        }
+    }
+    return cols;
+}
+
+// 모든 방정식을 사용해 중간 기호를 풀어 out의 0..num_cols-1번째 기호에 씁니다.
+// 방정식 자체는 바뀌지 않으므로 실패하면 방정식을 더 추가한 뒤 다시 호출할 수 있습니다.
+// 계측 카운터는 dec->stats에 더합니다.
+bool inactivation_solve(inactivation_decoder* dec, symbolMatrix* out) {
+    decoderStats* stats = &dec->stats;
+    int n = dec->num_cols;
+    int rows = dec->num_rows;
+    size_t ss = dec->symbol_size;
+    if (rows + dec->num_dense < n) {
+        return false;
+    }
+    STATS_TIMER(peel_start);
+
+    // 열 -> 행 인접 목록 (CSR)
+    int* adj_start = (int*)calloc(n + 1, sizeof(int));
+    for (int r = 0; r < rows; r++) {
+        for (int j = 0; j < dec->row_degree[r]; j++) {
+            adj_start[dec->row_indices[r][j] + 1]++;
+        }
+    }
+    for (int c = 0; c < n; c++) {
+        adj_start[c + 1] += adj_start[c];
+    }
+    int* fill = (int*)malloc(n * sizeof(int));
+    memcpy(fill, adj_start, n * sizeof(int));
+    int* adj = (int*)malloc((adj_start[n] > 0 ? adj_start[n] : 1) * sizeof(int));
+    for (int r = 0; r < rows; r++) {
+        for (int j = 0; j < dec->row_degree[r]; j++) {
+            adj[fill[dec->row_indices[r][j]]++] = r;
+        }
+    }
+    free(fill);
+
+    int* col_state = (int*)calloc(n, sizeof(int));
+    int* active_degree = (int*)malloc(rows * sizeof(int));
+    bool* used = (bool*)calloc(rows, sizeof(bool));
+    int* ripple = (int*)malloc(rows * sizeof(int));
+    int ripple_head = 0, ripple_tail = 0;
+    int* pivot_row = (int*)malloc(n * sizeof(int));
+    int* pivot_col = (int*)malloc(n * sizeof(int));
+    int num_pivots = 0;
+    int* inactive_cols = (int*)malloc(n * sizeof(int));
+    int num_inactive = 0;
+    int first_permanent = n - dec->num_permanent;
+    for (int c = first_permanent; c < n; c++) {
+        col_state[c] = COL_INACTIVE;
+        inactive_cols[num_inactive++] = c;
+    }
+    for (int r = 0; r < rows; r++) {
+        // 행의 열은 정렬되어 있으므로 처음부터 비활성인 열은 뒤쪽에 모여 있습니다.
+        int d = dec->row_degree[r];
+        while (d > 0 && dec->row_indices[r][d - 1] >= first_permanent) {
+            d--;
+        }
+        active_degree[r] = d;
+        if (active_degree[r] == 1) {
+            ripple[ripple_tail++] = r;
+        }
+    }
+
+    // 1단계: peeling. 막히면 활성 차수가 가장 작은 행에서 열 하나만 남기고
+    // 나머지를 비활성으로 옮깁니다.
+    int resolved = num_inactive;
+    while (resolved < n) {
+        if (ripple_head < ripple_tail) {
+            int r = ripple[ripple_head++];
+            if (used[r] || active_degree[r] != 1) {
+                continue;
+            }
+            int c = -1;
+            for (int j = 0; j < dec->row_degree[r]; j++) {
+                if (col_state[dec->row_indices[r][j]] == COL_ACTIVE) {
+                    c = dec->row_indices[r][j];
+                    break;
+                }
+            }
+            used[r] = true;
+            pivot_row[num_pivots] = r;
+            pivot_col[num_pivots++] = c;
+            resolve_column(c, COL_PIVOTED, col_state, adj_start, adj, used, active_degree, ripple, &ripple_tail);
+            resolved++;
+            continue;
+        }
+
+        int best = -1;
+        for (int r = 0; r < rows; r++) {
+            if (!used[r] && active_degree[r] >= 2 && (best < 0 || active_degree[r] < active_degree[best])) {
+                best = r;
+                if (active_degree[r] == 2) {
+                    break;
+                }
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+        bool kept = false;
+        for (int j = 0; j < dec->row_degree[best]; j++) {
+            int c = dec->row_indices[best][j];
+            if (col_state[c] != COL_ACTIVE) {
+                continue;
+            }
+            if (!kept) {
+                kept = true;
+                continue;
+            }
+            inactive_cols[num_inactive++] = c;
+            resolve_column(c, COL_INACTIVE, col_state, adj_start, adj, used, active_degree, ripple, &ripple_tail);
+            resolved++;
+        }
+    }
+    // 어떤 행에도 남지 않은 열은 밀집 시스템에서 풀어야 합니다.
+    for (int c = 0; c < n; c++) {
+        if (col_state[c] == COL_ACTIVE) {
+            col_state[c] = COL_INACTIVE;
+            inactive_cols[num_inactive++] = c;
+        }
+    }
+    int* inactive_index = (int*)malloc(n * sizeof(int));
+    for (int i = 0; i < num_inactive; i++) {
+        inactive_index[inactive_cols[i]] = i;
+    }
+
+    // 2단계: 피벗된 각 열을 (값) + (비활성 열들의 선형 결합)으로 표현합니다.
+    // 피벗 행에 등장하는 다른 열은 이미 피벗되었거나 비활성이므로 순서대로 계산됩니다.
+    gf2Matrix* inact = newGF2Matrix(n, num_inactive);
+    const uint8_t** srcs = (const uint8_t**)malloc((n + 1) * sizeof(uint8_t*));
+    for (int t = 0; t < num_pivots; t++) {
+        int r = pivot_row[t], c = pivot_col[t];
+        int num_srcs = 0;
+        if (dec->row_values[r]) {
+            srcs[num_srcs++] = dec->row_values[r];
+        }
+        for (int j = 0; j < dec->row_degree[r]; j++) {
+            int x = dec->row_indices[r][j];
+            if (x == c) {
+                continue;
+            }
+            if (col_state[x] == COL_INACTIVE) {
+                inact->rows[c][inactive_index[x] >> 6] ^= 1ULL << (inactive_index[x] & 63);
+            } else {
+                srcs[num_srcs++] = symbolAt(out, x);
+                gf2XorRowInto(inact, c, inact, x);
+            }
+        }
+        xorBytesGather(symbolAt(out, c), srcs, num_srcs, ss);
+        STATS_ADD(stats, xorBytes, num_srcs * ss);
+    }
+    STATS_ELAPSED(stats, peelNanos, peel_start);
+    STATS_SET(stats, peeled, num_pivots);
+    STATS_SET(stats, inactivated, num_inactive - dec->num_permanent);
+    STATS_TIMER(eliminate_start);
+
+    // 3단계: 사용하지 않은 행을 비활성 열에 대한 방정식으로 바꿔 소거합니다.
+    // 밀집 행은 a 뒤에 이어집니다.
+    int remaining = rows - num_pivots;
+    int total = remaining + dec->num_dense;
+    gf2Matrix* a = newGF2Matrix(remaining, num_inactive);
+    uint8_t* rhs_buf = (uint8_t*)malloc((total > 0 ? total : 1) * ss);
+    uint8_t** rhs = (uint8_t**)malloc((total > 0 ? total : 1) * sizeof(uint8_t*));
+    for (int r = 0, i = 0; r < rows; r++) {
+        if (used[r]) {
+            continue;
+        }
+        rhs[i] = rhs_buf + i * ss;
+        int num_srcs = 0;
+        if (dec->row_values[r]) {
+            srcs[num_srcs++] = dec->row_values[r];
+        }
+        for (int j = 0; j < dec->row_degree[r]; j++) {
+            int x = dec->row_indices[r][j];
+            if (col_state[x] == COL_INACTIVE) {
+                a->rows[i][inactive_index[x] >> 6] ^= 1ULL << (inactive_index[x] & 63);
+            } else {
+                srcs[num_srcs++] = symbolAt(out, x);
+                gf2XorRowInto(a, i, inact, x);
+            }
+        }
+        xorBytesGather(rhs[i], srcs, num_srcs, ss);
+        STATS_ADD(stats, xorBytes, num_srcs * ss);
+        i++;
+    }
+
+    uint8_t** m = NULL;
+    uint8_t* m_buf = NULL;
+    int rank = 0;
+    if (total >= num_inactive) {
+        if (dec->num_dense == 0) {
+            rank = reduce_gf2(a, rhs, ss, stats);
+        } else {
+            // 밀집 행을 피벗된 열의 (값, 비활성 결합)으로 대입해 GF(256) 시스템을 만듭니다.
+            m_buf = (uint8_t*)calloc((size_t)total * num_inactive + 1, 1);
+            m = (uint8_t**)malloc(total * sizeof(uint8_t*));
+            for (int i = 0; i < total; i++) {
+                m[i] = m_buf + (size_t)i * num_inactive;
+            }
+            for (int i = 0; i < remaining; i++) {
+                for (int b = gf2NextSet(a, i, 0); b >= 0; b = gf2NextSet(a, i, b + 1)) {
+                    m[i][b] = 1;
+                }
+            }
+            for (int d = 0; d < dec->num_dense; d++) {
+                int i = remaining + d;
+                const uint8_t* coeffs = dec->dense_coeffs[d];
+                rhs[i] = rhs_buf + i * ss;
+                if (dec->dense_values[d]) {
+                    memcpy(rhs[i], dec->dense_values[d], ss);
+                } else {
+                    memset(rhs[i], 0, ss);
+                }
+                for (int x = 0; x < n; x++) {
+                    uint8_t beta = coeffs[x];
+                    if (beta == 0) {
+                        continue;
+                    }
+                    if (col_state[x] == COL_INACTIVE) {
+                        m[i][inactive_index[x]] ^= beta;
+                        continue;
+                    }
+                    gf256MulAdd(rhs[i], symbolAt(out, x), beta, ss);
+                    STATS_ADD(stats, xorBytes, ss);
+                    for (int b = gf2NextSet(inact, x, 0); b >= 0; b = gf2NextSet(inact, x, b + 1)) {
+                        m[i][b] ^= beta;
+                    }
+                }
+            }
+            rank = reduce_gf256(m, total, num_inactive, rhs, ss, stats);
+        }
+    }
+    bool ok = rank == num_inactive;
+    STATS_ELAPSED(stats, eliminateNanos, eliminate_start);
+    STATS_SET(stats, eliminated, rank);
+    STATS_SET(stats, rank, num_pivots + rank);
+    STATS_MAX(stats, peakBytes, decoder_bytes(dec) +
+              sizeof(int) * (size_t)(5 * n + 5 * rows + adj_start[n] + total) + rows + (size_t)(n + 1) * sizeof(void*) +
+              (size_t)(n + remaining) * inact->stride * sizeof(uint64_t) + (size_t)total * (ss + sizeof(void*)) +
+              (m != NULL ? (size_t)total * num_inactive : 0));
+
+    // 4단계: 비활성 열의 값을 얻고 피벗된 열에 역대입합니다.
+    if (ok) {
+        STATS_TIMER(backsub_start);
+        for (int i = 0; i < num_inactive; i++) {
+            memcpy(symbolAt(out, inactive_cols[i]), rhs[i], ss);
+        }
+        for (int t = 0; t < num_pivots; t++) {
+            int c = pivot_col[t];
+            int num_srcs = 0;
+            for (int b = gf2NextSet(inact, c, 0); b >= 0; b = gf2NextSet(inact, c, b + 1)) {
+                srcs[num_srcs++] = symbolAt(out, inactive_cols[b]);
+            }
+            xorBytesMulti(symbolAt(out, c), srcs, num_srcs, ss);
+            STATS_ADD(stats, xorBytes, num_srcs * ss);
+        }
+        STATS_ELAPSED(stats, backsubNanos, backsub_start);
+        // 소거 후 0이 된 행은 새 정보를 주지 않았습니다.
+        STATS_SET(stats, redundantSymbols, total - rank);
+        STATS_DETERMINED(stats);
+    }
+
+    free(m);
+    free(m_buf);
+    freeGF2Matrix(a);
+    freeGF2Matrix(inact);
+    free(rhs_buf);
+    free(rhs);
+    free(srcs);
+    free(inactive_index);
+    free(inactive_cols);
+    free(pivot_row);
+    free(pivot_col);
+    free(ripple);
+    free(used);
+    free(active_degree);
+    free(col_state);
+    free(adj);
+    free(adj_start);
+    return ok;
+}
@@ -1,8 +1,16 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <limits.h>
 #include <math.h>
 #include "fountain.h"
+#include "xor.h"
+#include "gf2.h"
+#include "arena.h"
+#include "pool.h"
+#include "soliton.h"
+#include "sample.h"
+#include "prng.h"
 
 // Block structure: Internal representation for blocks during encoding/decoding
 typedef struct {
@@ -10,105 +18,158 @@ typedef struct {
     size_t length; // Block length
 } block;
 
-// SparseMatrix structure: Used for solving equations during decoding
-typedef struct {
-    int** coeff;   // Coefficients of the equations
-    block* v;      // Right-hand side of the equations
-    int size;      // Number of equations
-} sparseMatrix;
-
 // LubyCodec structure: Implementation of the Luby Transform codec
 typedef struct {
     Codec base;      // Base codec interface
     int sourceBlocks; // Number of source blocks
     unsigned int seed; // Random seed
-    double* degreeCDF; // Cumulative degree distribution function
-    int degreeCDFLength; // Length of degreeCDF array
+    const degreeDist* degrees; // Degree distribution, possibly shared with other codecs
 } LubyCodec;
 
-// LubyDecoder structure: State required for decoding Luby Transform messages
+// lubyEquation structure: A received block reduced by the sources solved so far
+typedef struct {
+    int* indices; // Source blocks still unknown in this equation
+    int degree;   // Number of entries in indices (0 once consumed)
+    block v;      // XOR of the unknown source blocks
+} lubyEquation;
+
+// LubyDecoder structure: State required for decoding Luby Transform messages.
+// Blocks are decoded by peeling degree-1 equations; only the stopping set
+// left over by peeling goes through Gaussian elimination.
 typedef struct {
     Decoder base;    // Base decoder interface
     LubyCodec* codec; // Reference to the codec
     int messageLength; // Length of the original message
-    sparseMatrix matrix; // Sparse matrix for solving equations
+    size_t blockLength; // Length of every encoded block
+    lubyEquation* equations; // Received equations
+    int numEquations;
+    int capEquations;
+    int** adj;       // For each source block, the equations that reference it
+    int* adjLen;
+    int* adjCap;
+    int* ripple;     // Queue of equations of degree 1
+    int rippleHead;
+    int rippleTail;
+    int rippleCap;
+    symbolMatrix* sources; // Solved source blocks (may alias a caller buffer)
+    bool compacted;  // The caller buffer already holds the message
+    bool* solved;
+    int numSolved;
+    int* batch;      // Index sets of the batch being added, back to back
+    int batchCap;
+    arena mem;       // Block copies, index lists and elimination scratch
+    decoderStats stats; // Updated only in FOUNTAIN_STATS builds
 } LubyDecoder;
 
-// Utility function to pick degree based on CDF
-int pickDegree(unsigned int* seed, double* degreeCDF, int degreeCDFLength) {
-    double r = (double)rand_r(seed) / RAND_MAX;
-    for (int i = 0; i < degreeCDFLength; i++) {
-        if (r < degreeCDF[i]) {
-            return i + 1;
-        }
-    }
-    return degreeCDFLength;
-}
+// Blocks per batch in AddBlocks_Luby
+#define ADD_BATCH 64
 
-// Utility function to sample indices uniformly
-int* sampleUniform(unsigned int* seed, int d, int max, int* outSize) {
-    int* indices = (int*)malloc(d * sizeof(int));
-    int* available = (int*)malloc(max * sizeof(int));
-    for (int i = 0; i < max; i++) {
-        available[i] = i;
-    }
-    for (int i = 0; i < d; i++) {
-        int index = rand_r(seed) % (max - i);
-        indices[i] = available[index];
-        available[index] = available[max - i - 1];
-    }
-    free(available);
-    *outSize = d;
-    return indices;
+// batchEntry structure: one block of an AddBlocks batch and its index set
+typedef struct {
+    int lowest; // Lowest source block in the set
+    int block;  // Position of the block in the batch
+    int offset; // Start of the set in the decoder's batch buffer
+    int count;  // Size of the set
+} batchEntry;
+
+bool AddBlocks_Luby(struct Decoder* decoder, LTBlock* blocks, int numBlocks);
+uint8_t* Decode_Luby(struct Decoder* decoder, int* outSize);
+void FreeDecoder_Luby(struct Decoder* decoder);
+const decoderStats* Stats_Luby(struct Decoder* decoder);
+Decoder* NewDecoderInto_Luby(struct Codec* codec, int messageLength, uint8_t* output);
+int SourceBlocks_Luby(struct Codec* codec);
+int PickIndicesInto_Luby(struct Codec* codec, int64_t codeBlockIndex, int* indices);
+
+// Pick a degree in O(1) from the distribution's alias table
+static int pickDegree(counterRng* rng, const degreeDist* degrees) {
+    double u = (double)(counterRngNext(rng) >> 11) * 0x1.0p-53;
+    return aliasSample(degrees->table, u);
 }
 
 // XOR two blocks
 void xorBlocks(uint8_t* dest, const uint8_t* src, size_t length) {
-    for (size_t i = 0; i < length; i++) {
-        dest[i] ^= src[i];
-    }
+    xorBytes(dest, src, length);
 }
 
-// Generate a single LT block from source blocks
-block generateLubyTransformBlock(block* source, int* indices, int numIndices) {
+// Generate a single LT block from source blocks in one pass over the output.
+// srcs is scratch with room for numIndices pointers.
+block generateLubyTransformBlock(const symbolMatrix* source, int* indices, int numIndices, const uint8_t** srcs) {
     block result;
-    result.data = (uint8_t*)malloc(source[0].length * sizeof(uint8_t));
-    result.length = source[0].length;
-    memset(result.data, 0, result.length);
+    result.data = (uint8_t*)malloc(source->symbolSize * sizeof(uint8_t));
+    result.length = source->symbolSize;
 
     for (int i = 0; i < numIndices; i++) {
-        xorBlocks(result.data, source[indices[i]].data, result.length);
+        srcs[i] = symbolAt(source, indices[i]);
     }
+    xorBytesGather(result.data, srcs, numIndices, result.length);
 
     return result;
 }
 
-// Generate intermediate blocks
-void GenerateIntermediateBlocks_Luby(struct Codec* codec, uint8_t* message, size_t messageLength, int numBlocks, uint8_t*** blocks, int* blockLength) {
+// Generate intermediate blocks. LT codes are not pre-coded, so these are the
+// source blocks themselves, padded to equal length in one contiguous buffer.
+symbolMatrix* GenerateIntermediateBlocks_Luby(struct Codec* codec, uint8_t* message, size_t messageLength, int numBlocks) {
+    return partitionSymbols(message, (int)messageLength, numBlocks, 1);
+}
+
+// Write the indices for a code block into indices, which must hold
+// sourceBlocks ints. Returns the number written. Sampling is O(degree).
+int PickIndicesInto_Luby(struct Codec* codec, int64_t codeBlockIndex, int* indices) {
     LubyCodec* lubyCodec = (LubyCodec*)codec;
-    PartitionBytes(message, messageLength, lubyCodec->sourceBlocks, blocks, blockLength);
+    // Keyed by (seed, full 64-bit block ID) so the encoder and decoder agree
+    // regardless of call order, and IDs 2^32 apart get unrelated indices
+    counterRng rng;
+    counterRngInit(&rng, lubyCodec->seed, codeBlockIndex);
+    int degree = pickDegree(&rng, lubyCodec->degrees);
+    unsigned int seed = (unsigned int)counterRngNext(&rng);
+    return sampleUniformInto(&seed, degree, lubyCodec->sourceBlocks, indices, false);
+}
+
+// Most indices one code block can pick: no degree exceeds the largest one in
+// the distribution
+static int maxIndices(const LubyCodec* codec) {
+    int maxDegree = codec->degrees->size - 1;
+    return maxDegree < codec->sourceBlocks ? maxDegree : codec->sourceBlocks;
 }
 
 // Pick indices for a code block
 int* PickIndices_Luby(struct Codec* codec, int64_t codeBlockIndex, int* outSize) {
-    LubyCodec* lubyCodec = (LubyCodec*)codec;
-    int degree = pickDegree(&lubyCodec->seed, lubyCodec->degreeCDF, lubyCodec->degreeCDFLength);
-    return sampleUniform(&lubyCodec->seed, degree, lubyCodec->sourceBlocks, outSize);
+    int* indices = (int*)malloc(maxIndices((LubyCodec*)codec) * sizeof(int));
+    *outSize = PickIndicesInto_Luby(codec, codeBlockIndex, indices);
+    return indices;
 }
 
 // Create a new Luby decoder
 Decoder* NewDecoder_Luby(struct Codec* codec, int messageLength) {
+    return NewDecoderInto_Luby(codec, messageLength, NULL);
+}
+
+// Create a Luby decoder whose source blocks alias output, which must hold
+// symbolBufferSize(messageLength, sourceBlocks) bytes. Peeled blocks land in
+// place and Decode returns output itself, with no final copy.
+Decoder* NewDecoderInto_Luby(struct Codec* codec, int messageLength, uint8_t* output) {
     LubyCodec* lubyCodec = (LubyCodec*)codec;
-    LubyDecoder* decoder = (LubyDecoder*)malloc(sizeof(LubyDecoder));
+    int k = lubyCodec->sourceBlocks;
+    LubyDecoder* decoder = (LubyDecoder*)calloc(1, sizeof(LubyDecoder));
+    decoder->base.AddBlocks = AddBlocks_Luby;
+    decoder->base.Decode = Decode_Luby;
+    decoder->base.Free = FreeDecoder_Luby;
+    decoder->base.Stats = Stats_Luby;
     decoder->codec = lubyCodec;
     decoder->messageLength = messageLength;
-
-    decoder->matrix.coeff = (int**)malloc(lubyCodec->sourceBlocks * sizeof(int*));
-    for (int i = 0; i < lubyCodec->sourceBlocks; i++) {
-        decoder->matrix.coeff[i] = (int*)calloc(lubyCodec->sourceBlocks, sizeof(int));
+    decoder->stats.numCols = k;
+
+    decoder->solved = (bool*)calloc(k, sizeof(bool));
+    decoder->adj = (int**)calloc(k, sizeof(int*));
+    decoder->adjLen = (int*)calloc(k, sizeof(int));
+    decoder->adjCap = (int*)calloc(k, sizeof(int));
+    // Without an output buffer the symbol size is fixed by the first block that arrives
+    arenaInit(&decoder->mem, 0, 0);
+    if (output != NULL) {
+        int symbolSize = (messageLength + k - 1) / k;
+        decoder->sources = viewSymbols(output, k, symbolSize);
+        decoder->mem.symbolSize = symbolSize;
     }
-    decoder->matrix.v = (block*)malloc(lubyCodec->sourceBlocks * sizeof(block));
-    decoder->matrix.size = 0;
 
     return (Decoder*)decoder;
 }
@@ -116,7 +177,7 @@ Decoder* NewDecoder_Luby(struct Codec* codec, int messageLength) {
 // Free the Luby codec
 void FreeCodec_Luby(struct Codec* codec) {
     LubyCodec* lubyCodec = (LubyCodec*)codec;
-    free(lubyCodec->degreeCDF);
+    releaseDegreeDist(lubyCodec->degrees);
     free(lubyCodec);
 }
 
@@ -124,101 +185,380 @@ void FreeCodec_Luby(struct Codec* codec) {
 void FreeDecoder_Luby(struct Decoder* decoder) {
     LubyDecoder* lubyDecoder = (LubyDecoder*)decoder;
     for (int i = 0; i < lubyDecoder->codec->sourceBlocks; i++) {
-        free(lubyDecoder->matrix.coeff[i]);
+        free(lubyDecoder->adj[i]);
     }
-    free(lubyDecoder->matrix.coeff);
-    free(lubyDecoder->matrix.v);
+    arenaFree(&lubyDecoder->mem);
+    free(lubyDecoder->equations);
+    free(lubyDecoder->ripple);
+    freeSymbolMatrix(lubyDecoder->sources);
+    free(lubyDecoder->solved);
+    free(lubyDecoder->adj);
+    free(lubyDecoder->adjLen);
+    free(lubyDecoder->adjCap);
+    free(lubyDecoder->batch);
     free(lubyDecoder);
 }
 
-// Add blocks to the decoder
-bool AddBlocks_Luby(struct Decoder* decoder, LTBlock* blocks, int numBlocks) {
-    LubyDecoder* lubyDecoder = (LubyDecoder*)decoder;
+// Record that equation eq still references source block s
+static void addAdjacency(LubyDecoder* d, int s, int eq) {
+    if (d->adjLen[s] == d->adjCap[s]) {
+        d->adjCap[s] = d->adjCap[s] ? 2 * d->adjCap[s] : 4;
+        d->adj[s] = (int*)realloc(d->adj[s], d->adjCap[s] * sizeof(int));
+    }
+    d->adj[s][d->adjLen[s]++] = eq;
+}
+
+// Queue a degree-1 equation for peeling
+static void pushRipple(LubyDecoder* d, int eq) {
+    if (d->rippleTail == d->rippleCap) {
+        d->rippleCap = d->rippleCap ? 2 * d->rippleCap : 16;
+        d->ripple = (int*)realloc(d->ripple, d->rippleCap * sizeof(int));
+    }
+    d->ripple[d->rippleTail++] = eq;
+}
+
+// Mark source block s as solved with value v and substitute it into every
+// equation that still references it. Equations that drop to degree 1 join
+// the ripple. v is copied into the source matrix and returned to the arena.
+static void solveSource(LubyDecoder* d, int s, block v) {
+    uint8_t* source = symbolAt(d->sources, s);
+    memcpy(source, v.data, v.length);
+    arenaRelease(&d->mem, v.data);
+    d->solved[s] = true;
+    d->numSolved++;
+    STATS_ADD(&d->stats, peeled, 1);
+
+    for (int i = 0; i < d->adjLen[s]; i++) {
+        lubyEquation* e = &d->equations[d->adj[s][i]];
+        for (int j = 0; j < e->degree; j++) {
+            if (e->indices[j] == s) {
+                e->indices[j] = e->indices[--e->degree];
+                xorBlocks(e->v.data, source, e->v.length);
+                STATS_ADD(&d->stats, xorBytes, e->v.length);
+                if (e->degree == 1) {
+                    pushRipple(d, d->adj[s][i]);
+                }
+                break;
+            }
+        }
+    }
+    free(d->adj[s]);
+    d->adj[s] = NULL;
+    d->adjLen[s] = d->adjCap[s] = 0;
+}
+
+// Peel degree-1 equations until the ripple is empty
+static void peel(LubyDecoder* d) {
+    STATS_TIMER(t0);
+    while (d->rippleHead < d->rippleTail) {
+        lubyEquation* e = &d->equations[d->ripple[d->rippleHead++]];
+        if (e->degree != 1) {
+            // Already consumed, or reduced to zero by another equation
+            continue;
+        }
+        int s = e->indices[0];
+        block v = e->v;
+        e->degree = 0;
+        e->v.data = NULL;
+        if (d->solved[s]) {
+            arenaRelease(&d->mem, v.data);
+            STATS_ADD(&d->stats, redundantSymbols, 1);
+            continue;
+        }
+        solveSource(d, s, v);
+    }
+    if (d->rippleHead == d->rippleTail) {
+        d->rippleHead = d->rippleTail = 0;
+    }
+    STATS_ELAPSED(&d->stats, peelNanos, t0);
+}
+
+// Number of received equations that peeling has not resolved yet
+static int pendingEquations(LubyDecoder* d) {
+    int pending = 0;
+    for (int i = 0; i < d->numEquations; i++) {
+        if (d->equations[i].degree > 0) {
+            pending++;
+        }
+    }
+    return pending;
+}
+
+// Bytes held by the decoder: the arena, the equation table and owned sources
+static inline size_t decoderBytes(const LubyDecoder* d) {
+    size_t bytes = d->mem.reserved + (size_t)d->capEquations * sizeof(lubyEquation) +
+        (size_t)d->rippleCap * sizeof(int) + (size_t)d->batchCap * sizeof(int);
+    if (d->sources != NULL && d->sources->owned) {
+        bytes += (size_t)d->sources->count * d->sources->stride;
+    }
+    return bytes;
+}
+
+static int compareBatchEntries(const void* a, const void* b) {
+    const batchEntry* x = (const batchEntry*)a;
+    const batchEntry* y = (const batchEntry*)b;
+    if (x->lowest != y->lowest) {
+        return x->lowest < y->lowest ? -1 : 1;
+    }
+    return (x->block > y->block) - (x->block < y->block);
+}
+
+// Generate the index sets of a batch of blocks back to back in the decoder's
+// batch buffer, then order the batch by lowest source block so consecutive
+// insertions touch neighbouring sources and adjacency lists.
+static void pickBatch(LubyDecoder* d, const LTBlock* blocks, int numBlocks, batchEntry* entries) {
+    int cap = maxIndices(d->codec);
+    int used = 0;
     for (int i = 0; i < numBlocks; i++) {
-        int outSize;
-        int* indices = lubyDecoder->codec->base.PickIndices(&lubyDecoder->codec->base, blocks[i].blockCode, &outSize);
-        
-        // Add equation to the sparse matrix
-        for (int j = 0; j < outSize; j++) {
-            lubyDecoder->matrix.coeff[lubyDecoder->matrix.size][indices[j]] = 1;
+        if (used + cap > d->batchCap) {
+            d->batchCap = used + cap > 2 * d->batchCap ? used + cap : 2 * d->batchCap;
+            d->batch = (int*)realloc(d->batch, d->batchCap * sizeof(int));
+        }
+        int* indices = d->batch + used;
+        int count = PickIndicesInto_Luby(&d->codec->base, blocks[i].blockCode, indices);
+        int lowest = INT_MAX;
+        for (int j = 0; j < count; j++) {
+            lowest = indices[j] < lowest ? indices[j] : lowest;
         }
-        lubyDecoder->matrix.v[lubyDecoder->matrix.size].data = blocks[i].data;
-        lubyDecoder->matrix.v[lubyDecoder->matrix.size].length = blocks[i].length;
-        lubyDecoder->matrix.size++;
+        entries[i].lowest = lowest;
+        entries[i].block = i;
+        entries[i].offset = used;
+        entries[i].count = count;
+        used += count;
+    }
+    qsort(entries, numBlocks, sizeof(batchEntry), compareBatchEntries);
+}
+
+// Insert one received block whose index set is indices[0..outSize)
+static void addEquation_Luby(LubyDecoder* lubyDecoder, const LTBlock* received, int* indices, int outSize) {
+    // The decoder owns its copy since peeling XORs into it
+    if (lubyDecoder->sources == NULL) {
+        lubyDecoder->mem.symbolSize = received->length;
+        lubyDecoder->sources = newSymbolMatrix(lubyDecoder->codec->sourceBlocks, (int)received->length, 1);
+    }
+    block v;
+    v.length = received->length;
+    v.data = arenaSymbol(&lubyDecoder->mem);
+    memcpy(v.data, received->data, v.length);
+    lubyDecoder->blockLength = v.length;
+    STATS_ADD(&lubyDecoder->stats, symbolsAdded, 1);
+
+    // Substitute the sources we already know
+    int degree = 0;
+    for (int j = 0; j < outSize; j++) {
+        if (lubyDecoder->solved[indices[j]]) {
+            xorBlocks(v.data, symbolAt(lubyDecoder->sources, indices[j]), v.length);
+            STATS_ADD(&lubyDecoder->stats, xorBytes, v.length);
+        } else {
+            indices[degree++] = indices[j];
+        }
+    }
+    if (degree == 0) {
+        // Redundant: every source in it is already known
+        arenaRelease(&lubyDecoder->mem, v.data);
+        STATS_ADD(&lubyDecoder->stats, redundantSymbols, 1);
+        return;
+    }
+    int* stored = (int*)arenaAlloc(&lubyDecoder->mem, degree * sizeof(int));
+    memcpy(stored, indices, degree * sizeof(int));
+    indices = stored;
 
-        free(indices);
+    if (lubyDecoder->numEquations == lubyDecoder->capEquations) {
+        lubyDecoder->capEquations = lubyDecoder->capEquations ? 2 * lubyDecoder->capEquations : lubyDecoder->codec->sourceBlocks;
+        lubyDecoder->equations = (lubyEquation*)realloc(lubyDecoder->equations, lubyDecoder->capEquations * sizeof(lubyEquation));
     }
-    return lubyDecoder->matrix.size >= lubyDecoder->codec->sourceBlocks;
+    int eq = lubyDecoder->numEquations++;
+    lubyDecoder->equations[eq].indices = indices;
+    lubyDecoder->equations[eq].degree = degree;
+    lubyDecoder->equations[eq].v = v;
+    for (int j = 0; j < degree; j++) {
+        addAdjacency(lubyDecoder, indices[j], eq);
+    }
+    if (degree == 1) {
+        pushRipple(lubyDecoder, eq);
+    }
+    peel(lubyDecoder);
 }
 
-// Decode the message from the decoder
-uint8_t* Decode_Luby(struct Decoder* decoder, int* outSize) {
+// Add blocks to the decoder, ADD_BATCH at a time: the index sets of a batch
+// are generated together and inserted in order of their lowest source block.
+bool AddBlocks_Luby(struct Decoder* decoder, LTBlock* blocks, int numBlocks) {
     LubyDecoder* lubyDecoder = (LubyDecoder*)decoder;
-    if (lubyDecoder->matrix.size < lubyDecoder->codec->sourceBlocks) {
-        return NULL;
+    STATS_TIMER(t0);
+    batchEntry entries[ADD_BATCH];
+    for (int start = 0; start < numBlocks; start += ADD_BATCH) {
+        int n = numBlocks - start < ADD_BATCH ? numBlocks - start : ADD_BATCH;
+        pickBatch(lubyDecoder, blocks + start, n, entries);
+        for (int i = 0; i < n; i++) {
+            addEquation_Luby(lubyDecoder, &blocks[start + entries[i].block],
+                             lubyDecoder->batch + entries[i].offset, entries[i].count);
+        }
+    }
+    bool ready = lubyDecoder->numSolved == lubyDecoder->codec->sourceBlocks ||
+        lubyDecoder->numSolved + pendingEquations(lubyDecoder) >= lubyDecoder->codec->sourceBlocks;
+    STATS_SET(&lubyDecoder->stats, rank, lubyDecoder->numSolved);
+    if (lubyDecoder->numSolved == lubyDecoder->codec->sourceBlocks) {
+        STATS_DETERMINED(&lubyDecoder->stats);
     }
+    STATS_MAX(&lubyDecoder->stats, peakBytes, decoderBytes(lubyDecoder));
+    STATS_ELAPSED(&lubyDecoder->stats, addNanos, t0);
+    return ready;
+}
 
-    int messageSize = lubyDecoder->messageLength;
-    uint8_t* decodedMessage = (uint8_t*)malloc(messageSize * sizeof(uint8_t));
-    memset(decodedMessage, 0, messageSize);
+// Solve the stopping set left over by peeling with Gaussian elimination.
+// Only the unsolved source blocks and the unresolved equations take part.
+// The coefficients are eliminated first and the row operations logged, so
+// the equation blocks are left untouched when the system is not yet solvable.
+static bool eliminateResidual(LubyDecoder* d) {
+    STATS_TIMER(t0);
+    int k = d->codec->sourceBlocks;
+    arenaMark mark = arenaSave(&d->mem);
+    int* column = (int*)arenaAlloc(&d->mem, k * sizeof(int));
+    int* unknowns = (int*)arenaAlloc(&d->mem, k * sizeof(int));
+    int numUnknowns = 0;
+    for (int s = 0; s < k; s++) {
+        column[s] = -1;
+        if (!d->solved[s]) {
+            column[s] = numUnknowns;
+            unknowns[numUnknowns++] = s;
+        }
+    }
 
-    // Perform Gaussian elimination
-    for (int i = 0; i < lubyDecoder->codec->sourceBlocks; i++) {
-        if (lubyDecoder->matrix.coeff[i][i] == 0) {
-            for (int j = i + 1; j < lubyDecoder->codec->sourceBlocks; j++) {
-                if (lubyDecoder->matrix.coeff[j][i] != 0) {
-                    int* tempCoeff = lubyDecoder->matrix.coeff[i];
-                    lubyDecoder->matrix.coeff[i] = lubyDecoder->matrix.coeff[j];
-                    lubyDecoder->matrix.coeff[j] = tempCoeff;
-
-                    block tempV = lubyDecoder->matrix.v[i];
-                    lubyDecoder->matrix.v[i] = lubyDecoder->matrix.v[j];
-                    lubyDecoder->matrix.v[j] = tempV;
-                    break;
-                }
-            }
+    // Coefficients are packed 64 per word
+    gf2Matrix* m = newGF2Matrix(pendingEquations(d), numUnknowns);
+    int* origin = (int*)arenaAlloc(&d->mem, m->numRows * sizeof(int));
+    for (int i = 0, r = 0; i < d->numEquations; i++) {
+        lubyEquation* e = &d->equations[i];
+        if (e->degree == 0) {
+            continue;
+        }
+        for (int j = 0; j < e->degree; j++) {
+            gf2Set(m, r, column[e->indices[j]]);
         }
-        for (int j = i + 1; j < lubyDecoder->codec->sourceBlocks; j++) {
-            if (lubyDecoder->matrix.coeff[j][i] != 0) {
-                for (int k = 0; k < lubyDecoder->codec->sourceBlocks; k++) {
-                    lubyDecoder->matrix.coeff[j][k] ^= lubyDecoder->matrix.coeff[i][k];
+        origin[r++] = i;
+    }
+
+    int* ops = NULL; // pairs of (target equation, pivot equation)
+    int numOps = 0, capOps = 0;
+    bool ok = m->numRows >= numUnknowns;
+    for (int c = 0; ok && c < numUnknowns; c++) {
+        int pivot = gf2FindPivot(m, c, c);
+        if (pivot < 0) {
+            ok = false;
+            break;
+        }
+        if (pivot != c) {
+            gf2SwapRows(m, c, pivot);
+            int tempOrigin = origin[c];
+            origin[c] = origin[pivot];
+            origin[pivot] = tempOrigin;
+        }
+        for (int r = 0; r < m->numRows; r++) {
+            if (r != c && gf2Get(m, r, c)) {
+                gf2XorRows(m, r, c, c);
+                if (numOps == capOps) {
+                    capOps = capOps ? 2 * capOps : 2 * m->numRows;
+                    ops = (int*)realloc(ops, 2 * capOps * sizeof(int));
                 }
-                xorBlocks(lubyDecoder->matrix.v[j].data, lubyDecoder->matrix.v[i].data, lubyDecoder->matrix.v[j].length);
+                ops[2 * numOps] = origin[r];
+                ops[2 * numOps + 1] = origin[c];
+                numOps++;
             }
         }
     }
 
-    // Back substitution
-    for (int i = lubyDecoder->codec->sourceBlocks - 1; i >= 0; i--) {
-        for (int j = i - 1; j >= 0; j--) {
-            if (lubyDecoder->matrix.coeff[j][i] != 0) {
-                xorBlocks(lubyDecoder->matrix.v[j].data, lubyDecoder->matrix.v[i].data, lubyDecoder->matrix.v[j].length);
-            }
+    STATS_MAX(&d->stats, peakBytes, decoderBytes(d) + (size_t)m->numRows * m->stride * sizeof(uint64_t) +
+              (size_t)capOps * 2 * sizeof(int));
+    STATS_ELAPSED(&d->stats, eliminateNanos, t0);
+    if (ok) {
+        STATS_TIMER(backsubStart);
+        for (int i = 0; i < numOps; i++) {
+            block* target = &d->equations[ops[2 * i]].v;
+            xorBlocks(target->data, d->equations[ops[2 * i + 1]].v.data, target->length);
+            STATS_ADD(&d->stats, xorBytes, target->length);
+        }
+        STATS_ADD(&d->stats, rowMerges, numOps);
+        STATS_ADD(&d->stats, eliminated, numUnknowns);
+        // Row c now holds source unknowns[c]
+        for (int c = 0; c < numUnknowns; c++) {
+            lubyEquation* e = &d->equations[origin[c]];
+            memcpy(symbolAt(d->sources, unknowns[c]), e->v.data, e->v.length);
+            arenaRelease(&d->mem, e->v.data);
+            d->solved[unknowns[c]] = true;
+            d->numSolved++;
+            e->degree = 0;
+            e->v.data = NULL;
         }
+        STATS_SET(&d->stats, rank, d->numSolved);
+        STATS_DETERMINED(&d->stats);
+        STATS_ELAPSED(&d->stats, backsubNanos, backsubStart);
     }
 
-    // Copy decoded message
-    for (int i = 0; i < lubyDecoder->codec->sourceBlocks; i++) {
-        memcpy(decodedMessage + i * lubyDecoder->matrix.v[i].length, lubyDecoder->matrix.v[i].data, lubyDecoder->matrix.v[i].length);
+    freeGF2Matrix(m);
+    free(ops);
+    arenaRewind(&d->mem, mark);
+    return ok;
+}
+
+// Instrumentation counters of the decoder. They stay zero unless the library
+// is built with FOUNTAIN_STATS.
+const decoderStats* Stats_Luby(struct Decoder* decoder) {
+    return &((LubyDecoder*)decoder)->stats;
+}
+
+// Decode the message from the decoder
+uint8_t* Decode_Luby(struct Decoder* decoder, int* outSize) {
+    LubyDecoder* lubyDecoder = (LubyDecoder*)decoder;
+    int k = lubyDecoder->codec->sourceBlocks;
+    if (lubyDecoder->numSolved < k && !eliminateResidual(lubyDecoder)) {
+        return NULL;
     }
 
-    *outSize = messageSize;
+    // Long blocks first, then short blocks: drop the padding in place
+    *outSize = lubyDecoder->messageLength;
+    if (!lubyDecoder->sources->owned) {
+        if (!lubyDecoder->compacted) {
+            compactSymbols(lubyDecoder->sources, k, lubyDecoder->messageLength);
+            lubyDecoder->compacted = true;
+        }
+        return lubyDecoder->sources->data;
+    }
+    size_t size = symbolBufferSize(lubyDecoder->messageLength, k);
+    uint8_t* decodedMessage = (uint8_t*)malloc(size);
+    memcpy(decodedMessage, lubyDecoder->sources->data, size);
+    symbolMatrix* view = viewSymbols(decodedMessage, k, lubyDecoder->sources->symbolSize);
+    compactSymbols(view, k, lubyDecoder->messageLength);
+    freeSymbolMatrix(view);
     return decodedMessage;
 }
-
-// Create a new Luby codec
+// Create a new Luby codec. degreeCDF[i] is the probability of a degree of at
+// most i + 1; it is copied, so the caller keeps ownership.
 Codec* NewLubyCodec(int sourceBlocks, unsigned int seed, double* degreeCDF, int degreeCDFLength) {
+    // Shift to the degree-indexed layout the shared distributions use
+    double* cdf = (double*)malloc((degreeCDFLength + 1) * sizeof(double));
+    cdf[0] = 0;
+    memcpy(cdf + 1, degreeCDF, degreeCDFLength * sizeof(double));
+    const degreeDist* degrees = wrapDegreeCDF(cdf, degreeCDFLength + 1);
+    Codec* codec = NewLubyCodecShared(sourceBlocks, seed, degrees);
+    releaseDegreeDist(degrees);
+    return codec;
+}
+
+// Create a new Luby codec over a shared degree distribution, such as one from
+// acquireRobustSoliton. The codec takes its own reference, so the caller may
+// release theirs straight away.
+Codec* NewLubyCodecShared(int sourceBlocks, unsigned int seed, const degreeDist* degrees) {
     LubyCodec* codec = (LubyCodec*)malloc(sizeof(LubyCodec));
     codec->sourceBlocks = sourceBlocks;
     codec->seed = seed;
-    codec->degreeCDF = (double*)malloc(degreeCDFLength * sizeof(double));
-    memcpy(codec->degreeCDF, degreeCDF, degreeCDFLength * sizeof(double));
-    codec->degreeCDFLength = degreeCDFLength;
+    codec->degrees = retainDegreeDist(degrees);
 
     codec->base.SourceBlocks = SourceBlocks_Luby;
     codec->base.GenerateIntermediateBlocks = GenerateIntermediateBlocks_Luby;
     codec->base.PickIndices = PickIndices_Luby;
+    codec->base.PickIndicesInto = PickIndicesInto_Luby;
     codec->base.NewDecoder = NewDecoder_Luby;
+    codec->base.NewDecoderInto = NewDecoderInto_Luby;
     codec->base.Free = FreeCodec_Luby;
 
     return (Codec*)codec;
@@ -226,30 +566,131 @@ Codec* NewLubyCodec(int sourceBlocks, unsigned int seed, double* degreeCDF, int
 
 // Encode a message into LT blocks
 LTBlock* EncodeLTBlocks(Codec* codec, uint8_t* message, size_t messageLength, int64_t* encodedBlockIDs, int numIDs, int* outSize) {
-    int blockLength;
-    uint8_t** intermediateBlocks;
-    codec->GenerateIntermediateBlocks(codec, message, messageLength, codec->SourceBlocks(codec), &intermediateBlocks, &blockLength);
+    symbolMatrix* intermediateBlocks = codec->GenerateIntermediateBlocks(codec, message, messageLength, codec->SourceBlocks(codec));
 
     LTBlock* ltBlocks = (LTBlock*)malloc(numIDs * sizeof(LTBlock));
+    const uint8_t** srcs = (const uint8_t**)malloc(codec->SourceBlocks(codec) * sizeof(uint8_t*));
+    int* indices = (int*)malloc(codec->SourceBlocks(codec) * sizeof(int));
     for (int i = 0; i < numIDs; i++) {
-        int outSize;
-        int* indices = codec->PickIndices(codec, encodedBlockIDs[i], &outSize);
+        int numIndices = codec->PickIndicesInto(codec, encodedBlockIDs[i], indices);
         ltBlocks[i].blockCode = encodedBlockIDs[i];
-        block b = generateLubyTransformBlock((block*)intermediateBlocks, indices, outSize);
+        block b = generateLubyTransformBlock(intermediateBlocks, indices, numIndices, srcs);
         ltBlocks[i].data = b.data;
         ltBlocks[i].length = b.length;
-        free(indices);
     }
+    free(indices);
+    free(srcs);
 
-    for (int i = 0; i < codec->SourceBlocks(codec); i++) {
-        free(intermediateBlocks[i]);
-    }
-    free(intermediateBlocks);
+    freeSymbolMatrix(intermediateBlocks);
 
     *outSize = numIDs;
     return ltBlocks;
 }
 
+// A batch of LT blocks encoded into one output array, shared by the pool threads
+typedef struct {
+    Codec* codec;
+    const symbolMatrix* source;
+    const int64_t* encodedBlockIDs; // NULL for the consecutive IDs firstID, firstID + 1, ...
+    int64_t firstID;
+    uint8_t* output;
+} ltBatch;
+
+// Encode blocks [begin, end) of a batch. Every block depends only on its ID
+// and is written to its own slot, so the result does not depend on how the
+// IDs are sharded.
+static void encodeBatchRange(void* arg, int begin, int end) {
+    ltBatch* batch = (ltBatch*)arg;
+    const symbolMatrix* source = batch->source;
+    const uint8_t** srcs = (const uint8_t**)malloc(source->count * sizeof(uint8_t*));
+    int* indices = (int*)malloc(source->count * sizeof(int));
+    for (int i = begin; i < end; i++) {
+        int64_t id = batch->encodedBlockIDs ? batch->encodedBlockIDs[i] : batch->firstID + i;
+        int outSize = batch->codec->PickIndicesInto(batch->codec, id, indices);
+        for (int j = 0; j < outSize; j++) {
+            srcs[j] = symbolAt(source, indices[j]);
+        }
+        xorBytesGather(batch->output + (size_t)i * source->symbolSize, srcs, outSize, source->symbolSize);
+    }
+    free(indices);
+    free(srcs);
+}
+
+// Shard a batch of IDs across pool (NULL encodes on the calling thread)
+static void encodeBatch(Codec* codec, const symbolMatrix* source, const int64_t* encodedBlockIDs, int64_t firstID, int numIDs, uint8_t* output, threadPool* pool) {
+    ltBatch batch;
+    batch.codec = codec;
+    batch.source = source;
+    batch.encodedBlockIDs = encodedBlockIDs;
+    batch.firstID = firstID;
+    batch.output = output;
+    // A few chunks per thread keeps the cores busy when block degrees vary
+    int grain = numIDs / (threadPoolSize(pool) * 8);
+    threadPoolFor(pool, numIDs, grain > 0 ? grain : 1, encodeBatchRange, &batch);
+}
+
+// Encode a batch of LT blocks into output, which must hold numIDs blocks of
+// ceil(messageLength / SourceBlocks) bytes each; block i starts at
+// output + i * blockLength. The IDs are sharded across pool (NULL encodes on
+// the calling thread) with the same bytes as EncodeLTBlocks. Returns the
+// block length.
+size_t EncodeLTBlocksInto(Codec* codec, uint8_t* message, size_t messageLength, const int64_t* encodedBlockIDs, int numIDs, uint8_t* output, threadPool* pool) {
+    symbolMatrix* intermediateBlocks = codec->GenerateIntermediateBlocks(codec, message, messageLength, codec->SourceBlocks(codec));
+    encodeBatch(codec, intermediateBlocks, encodedBlockIDs, 0, numIDs, output, pool);
+
+    size_t blockLength = intermediateBlocks->symbolSize;
+    freeSymbolMatrix(intermediateBlocks);
+    return blockLength;
+}
+
+// Create a streaming encoder. The message is partitioned once and its
+// intermediate blocks stay resident until FreeLTEncoder, so a sender can keep
+// asking for repair blocks without re-reading the message. The codec must
+// outlive the encoder; the message may be freed straight away.
+LTEncoder* NewLTEncoder(Codec* codec, uint8_t* message, size_t messageLength) {
+    LTEncoder* encoder = (LTEncoder*)malloc(sizeof(LTEncoder));
+    encoder->codec = codec;
+    encoder->intermediate = codec->GenerateIntermediateBlocks(codec, message, messageLength, codec->SourceBlocks(codec));
+    if (!encoder->intermediate->owned) {
+        // A zero-copy view would dangle once the caller frees the message
+        symbolMatrix* copy = newSymbolMatrix(encoder->intermediate->count, encoder->intermediate->symbolSize, 1);
+        memcpy(copy->data, encoder->intermediate->data, (size_t)copy->count * copy->stride);
+        freeSymbolMatrix(encoder->intermediate);
+        encoder->intermediate = copy;
+    }
+    encoder->nextID = 0;
+    return encoder;
+}
+
+// Length in bytes of every block the encoder produces
+size_t LTEncoderBlockLength(const LTEncoder* encoder) {
+    return encoder->intermediate->symbolSize;
+}
+
+// Encode the next n blocks into output (n * LTEncoderBlockLength bytes) and
+// advance the encoder. Block i gets ID first + i, where first is returned.
+// IDs run up to INT64_MAX, so there is no practical limit on repair blocks.
+int64_t NextLTBlocks(LTEncoder* encoder, int n, uint8_t* output, threadPool* pool) {
+    int64_t first = encoder->nextID;
+    encodeBatch(encoder->codec, encoder->intermediate, NULL, first, n, output, pool);
+    encoder->nextID += n;
+    return first;
+}
+
+// Encode the blocks with the given IDs into output without moving the
+// encoder, e.g. to resend blocks a receiver asked for
+void EncodeLTBlocksAt(LTEncoder* encoder, const int64_t* encodedBlockIDs, int numIDs, uint8_t* output, threadPool* pool) {
+    encodeBatch(encoder->codec, encoder->intermediate, encodedBlockIDs, 0, numIDs, output, pool);
+}
+
+// Free the streaming encoder (the codec is left alone)
+void FreeLTEncoder(LTEncoder* encoder) {
+    if (encoder != NULL) {
+        freeSymbolMatrix(encoder->intermediate);
+        free(encoder);
+    }
+}
+
 // Retrieve the number of source blocks for the Luby codec
 int SourceBlocks_Luby(struct Codec* codec) {
     LubyCodec* lubyCodec = (LubyCodec*)codec;
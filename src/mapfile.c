@@ -0,0 +1,171 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "mapfile.h"
+
+// 파일을 읽기 전용으로 매핑합니다. 원본 블록은 이 매핑을 그대로 가리키므로
+// 메시지를 힙에 읽어 들이지 않고, 실제 읽기는 커널 페이지 캐시가 맡습니다.
+// 실패하면 NULL을 돌려줍니다.
+mappedFile* MapInputFile(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    mappedFile* file = (mappedFile*)malloc(sizeof(mappedFile));
+    file->fd = fd;
+    file->length = (uint64_t)st.st_size;
+    file->writable = false;
+    file->data = NULL;
+    file->path = NULL;
+    file->tempPath = NULL;
+    if (file->length > 0) {
+        void* p = mmap(NULL, file->length, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            free(file);
+            return NULL;
+        }
+        // 원본 블록은 앞에서부터 차례로 읽힙니다.
+        madvise(p, file->length, MADV_SEQUENTIAL);
+        file->data = (uint8_t*)p;
+    }
+    return file;
+}
+
+// path와 같은 디렉터리에 새 임시 파일을 만듭니다. 이미 있는 이름은 건드리지 않고
+// 다음 이름을 시도합니다. 만든 이름은 *tempPath에 담깁니다.
+static int create_temp_file(const char* path, char** tempPath) {
+    size_t size = strlen(path) + 32;
+    char* temp = (char*)malloc(size);
+    for (int attempt = 0; attempt < 100; attempt++) {
+        snprintf(temp, size, "%s.%d.%d.part", path, (int)getpid(), attempt);
+        int fd = open(temp, O_RDWR | O_CREAT | O_EXCL, 0644);
+        if (fd >= 0) {
+            *tempPath = temp;
+            return fd;
+        }
+        if (errno != EEXIST) {
+            break;
+        }
+    }
+    free(temp);
+    return -1;
+}
+
+// 매핑과 파일을 닫기만 합니다.
+static bool release_mapped_file(mappedFile* file) {
+    bool ok = true;
+    if (file->data != NULL) {
+        if (file->writable) {
+            ok = msync(file->data, file->length, MS_SYNC) == 0;
+        }
+        ok = munmap(file->data, file->length) == 0 && ok;
+    }
+    return close(file->fd) == 0 && ok;
+}
+
+static void free_mapped_file(mappedFile* file) {
+    free(file->path);
+    free(file->tempPath);
+    free(file);
+}
+
+// length 바이트의 출력 파일을 만들고 쓰기용으로 매핑합니다. 디코더는 복원한
+// 원본 기호를 이 매핑에 바로 씁니다. 실제로는 같은 디렉터리의 임시 파일에 쓰고
+// CloseMappedFile이 성공했을 때만 path로 옮기므로, path에 있던 파일은 그 전까지
+// 그대로 남습니다.
+mappedFile* CreateOutputFile(const char* path, uint64_t length) {
+    char* tempPath = NULL;
+    int fd = create_temp_file(path, &tempPath);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    mappedFile* file = (mappedFile*)malloc(sizeof(mappedFile));
+    file->fd = fd;
+    file->length = length;
+    file->writable = true;
+    file->data = NULL;
+    file->path = strdup(path);
+    file->tempPath = tempPath;
+    if (ftruncate(fd, (off_t)length) != 0) {
+        DiscardOutputFile(file);
+        return NULL;
+    }
+    if (length > 0) {
+        void* p = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            DiscardOutputFile(file);
+            return NULL;
+        }
+        file->data = (uint8_t*)p;
+    }
+    return file;
+}
+
+// 매핑을 해제하고 파일을 닫습니다. 출력 파일이면 먼저 디스크에 내려 쓰고 임시
+// 파일을 path로 옮깁니다. 어느 단계든 실패하면 임시 파일만 지웁니다.
+bool CloseMappedFile(mappedFile* file) {
+    if (file == NULL) {
+        return true;
+    }
+    bool ok = release_mapped_file(file);
+    if (file->tempPath != NULL) {
+        ok = ok && rename(file->tempPath, file->path) == 0;
+        if (!ok) {
+            unlink(file->tempPath);
+        }
+    }
+    free_mapped_file(file);
+    return ok;
+}
+
+// 출력 파일을 path로 옮기지 않고 닫은 뒤 임시 파일을 지웁니다.
+void DiscardOutputFile(mappedFile* file) {
+    if (file == NULL) {
+        return;
+    }
+    if (file->data != NULL) {
+        munmap(file->data, file->length);
+    }
+    close(file->fd);
+    if (file->tempPath != NULL) {
+        unlink(file->tempPath);
+    }
+    free_mapped_file(file);
+}
+
+// 매핑된 입력 파일을 객체로 보고 인코딩합니다 (EncodeRaptorObject와 같은 출력 배치).
+// oti는 파일 길이로 만든 것이어야 합니다.
+bool EncodeRaptorFile(const mappedFile* input, const RaptorObjectInfo* oti, const uint16_t* esis, int numEsis, uint8_t* output, threadPool* pool) {
+    if (input->data == NULL || input->length != oti->F) {
+        return false;
+    }
+    return EncodeRaptorObject(oti, input->data, esis, numEsis, output, pool);
+}
+
+// 받은 기호로 객체를 복원해 path에 씁니다. 출력 파일을 F 바이트로 미리 잡고
+// 매핑한 뒤 원본 블록을 그 자리에 바로 디코딩하므로 객체 전체를 힙에 두지
+// 않습니다. 실패하면 임시 파일만 지우고 false를 돌려주며 path는 그대로입니다.
+bool DecodeRaptorFile(const char* path, const RaptorObjectInfo* oti, const ObjectSymbol* symbols, int numSymbols, threadPool* pool) {
+    mappedFile* output = CreateOutputFile(path, oti->F);
+    if (output == NULL) {
+        return false;
+    }
+    if (!DecodeRaptorObject(oti, symbols, numSymbols, output->data, pool)) {
+        DiscardOutputFile(output);
+        return false;
+    }
+    return CloseMappedFile(output);
+}
@@ -1,21 +1,16 @@
 #include <stdint.h>
 #include <stdbool.h>
+#include "mersenne.h"
 
 // 32-bit Mersenne Twister MT19937
 
-typedef struct {
-    uint32_t mt[624];
-    int index;
-    bool initialized;
-} MersenneTwister;
-
-// Function prototypes
-void initializeMT(MersenneTwister* t, uint32_t seed);
-void generateUntemperedMT(MersenneTwister* t);
-uint32_t uint32(MersenneTwister* t);
-int64_t int63(MersenneTwister* t);
-void seedMT(MersenneTwister* t, int64_t seed);
-MersenneTwister newMersenneTwister(int64_t seed);
+static inline uint32_t temperMT(uint32_t y) {
+    y ^= y >> 11;
+    y ^= (y << 7) & 0x9d2c5680;
+    y ^= (y << 15) & 0xefc60000;
+    y ^= y >> 18;
+    return y;
+}
 
 MersenneTwister newMersenneTwister(int64_t seed) {
     MersenneTwister t;
@@ -47,12 +42,7 @@ uint32_t uint32(MersenneTwister* t) {
     if (t->index >= 624) {
         t->index = 0;
     }
-    y ^= y >> 11;
-    y ^= (y << 7) & 0x9d2c5680;
-    y ^= (y << 15) & 0xefc60000;
-    y ^= y >> 18;
-
-    return y;
+    return temperMT(y);
 }
 
 void initializeMT(MersenneTwister* t, uint32_t seed) {
@@ -73,22 +63,40 @@ void generateUntemperedMT(MersenneTwister* t) {
     }
 }
 
+// Fast path for "seed, then draw a handful": writes the first n outputs of a
+// generator seeded with seedMT(seed) without building the full state.
+// Output j of the first twist reads only initial words j, j+1 and j+MT_M, so
+// just the first MT_M+n words of the seeding recurrence are computed and
+// only n of them are twisted: ~400 word ops for a few draws instead of
+// 624 to seed plus 624 to twist. n must not exceed MT_N - MT_M.
+void drawMT(int64_t seed, uint32_t* out, int n) {
+    static const uint32_t mag01[2] = {0x0, 0x9908b0df};
+    uint32_t head[MT_N - MT_M + 1];
+    uint32_t x = (uint32_t)(((seed >> 32) ^ seed) & 0xFFFFFFFF);
+
+    head[0] = x;
+    for (int i = 1; i < MT_M + n; i++) {
+        x = 1812433253U * (x ^ (x >> 30)) + i;
+        if (i <= n) {
+            head[i] = x;
+        }
+        if (i >= MT_M) {
+            int j = i - MT_M;
+            uint32_t y = (head[j] & 0x80000000) | (head[j + 1] & 0x7fffffff);
+            out[j] = temperMT(x ^ (y >> 1) ^ mag01[y & 0x1]);
+        }
+    }
+}
+
 // 64-bit Mersenne Twister MT19937-64
 
-typedef struct {
-    uint64_t mt[312];
-    int index;
-    bool initialized;
-} MersenneTwister64;
-
-// Function prototypes
-void initializeMT64(MersenneTwister64* t, uint64_t seed);
-void generateUntemperedMT64(MersenneTwister64* t);
-uint64_t uint64(MersenneTwister64* t);
-int64_t int63_64(MersenneTwister64* t);
-void seedMT64(MersenneTwister64* t, int64_t seed);
-MersenneTwister64 newMersenneTwister64(int64_t seed);
-void seedSliceMT64(MersenneTwister64* t, const uint64_t* seed, int seedLength);
+static inline uint64_t temperMT64(uint64_t y) {
+    y ^= (y >> 29) & 0x5555555555555555ULL;
+    y ^= (y << 17) & 0x71d67fffeda60000ULL;
+    y ^= (y << 37) & 0xfff7eee000000000ULL;
+    y ^= y >> 43;
+    return y;
+}
 
 MersenneTwister64 newMersenneTwister64(int64_t seed) {
     MersenneTwister64 t;
@@ -118,12 +126,7 @@ uint64_t uint64(MersenneTwister64* t) {
     if (t->index >= 312) {
         t->index = 0;
     }
-    y ^= (y >> 29) & 0x5555555555555555ULL;
-    y ^= (y << 17) & 0x71d67fffeda60000ULL;
-    y ^= (y << 37) & 0xfff7eee000000000ULL;
-    y ^= y >> 43;
-
-    return y;
+    return temperMT64(y);
 }
 
 void initializeMT64(MersenneTwister64* t, uint64_t seed) {
@@ -176,4 +179,25 @@ void generateUntemperedMT64(MersenneTwister64* t) {
         uint64_t y = (t->mt[i] & 0xFFFFFFFF80000000ULL) | (t->mt[(i + 1) % 312] & 0x7FFFFFFFULL);
         t->mt[i] = t->mt[(i + 156) % 312] ^ (y >> 1) ^ mag01[y & 0x1];
     }
-}
\ No newline at end of file
+}
+
+// 64-bit counterpart of drawMT: the first n outputs of seedMT64(seed), computing
+// only the first MT64_M+n seeding words. n must not exceed MT64_N - MT64_M.
+void drawMT64(int64_t seed, uint64_t* out, int n) {
+    static const uint64_t mag01[2] = {0x0ULL, 0xb5026f5aa96619e9ULL};
+    uint64_t head[MT64_N - MT64_M + 1];
+    uint64_t x = (uint64_t)seed;
+
+    head[0] = x;
+    for (int i = 1; i < MT64_M + n; i++) {
+        x = 6364136223846793005ULL * (x ^ (x >> 62)) + i;
+        if (i <= n) {
+            head[i] = x;
+        }
+        if (i >= MT64_M) {
+            int j = i - MT64_M;
+            uint64_t y = (head[j] & 0xFFFFFFFF80000000ULL) | (head[j + 1] & 0x7FFFFFFFULL);
+            out[j] = temperMT64(x ^ (y >> 1) ^ mag01[y & 0x1]);
+        }
+    }
+}
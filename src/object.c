@@ -0,0 +1,351 @@
+#include <stdlib.h>
+#include <string.h>
+#include "object.h"
+
+// RFC 5053의 R10 코드가 다루는 가장 작은 원본 블록
+#define MIN_SOURCE_SYMBOLS 4
+
+// Partition[I, J] (RFC 5053 5.3.1.2). I를 J개로 나눠 크기 IL인 것 JL개와
+// 크기 IS인 것 JS개로 만듭니다.
+static void partition_rfc(int i, int j, int* il, int* is, int* jl, int* js) {
+    *il = (i + j - 1) / j;
+    *is = i / j;
+    *jl = i - *is * j;
+    *js = j - *jl;
+}
+
+// 객체 분할. F바이트 객체를 T바이트 기호로 나누고, 블록당 기호 수가
+// MAX_SOURCE_SYMBOLS를 넘지 않도록 원본 블록 수 Z를, 한 하위 블록이 W바이트
+// 안에 들도록 하위 블록 수 N을 정합니다 (RFC 5053 4.2의 권장 방식).
+// 기호가 MIN_SOURCE_SYMBOLS개보다 적거나 T가 Al의 배수가 아니면 false를 돌려줍니다.
+bool InitRaptorObjectInfo(RaptorObjectInfo* oti, uint64_t F, int T, int Al, uint64_t W) {
+    if (F == 0 || Al <= 0 || T < Al || T % Al != 0 || W == 0) {
+        return false;
+    }
+    uint64_t kt = (F + T - 1) / T;
+    if (kt < MIN_SOURCE_SYMBOLS) {
+        return false;
+    }
+    uint64_t z = (kt + MAX_SOURCE_SYMBOLS - 1) / MAX_SOURCE_SYMBOLS;
+    uint64_t blockBytes = (kt + z - 1) / z * (uint64_t)T;
+    uint64_t n = (blockBytes + W - 1) / W;
+    if (n > (uint64_t)(T / Al)) {
+        n = T / Al;
+    }
+
+    oti->F = F;
+    oti->Al = Al;
+    oti->T = T;
+    oti->Z = (int)z;
+    oti->N = (int)n;
+    partition_rfc((int)kt, oti->Z, &oti->KL, &oti->KS, &oti->ZL, &oti->ZS);
+    partition_rfc(T / Al, oti->N, &oti->TL, &oti->TS, &oti->NL, &oti->NS);
+    return oti->KS >= MIN_SOURCE_SYMBOLS || oti->ZS == 0;
+}
+
+int SourceBlockSymbols(const RaptorObjectInfo* oti, int sbn) {
+    return sbn < oti->ZL ? oti->KL : oti->KS;
+}
+
+// 원본 블록 sbn의 첫 바이트 위치
+uint64_t SourceBlockOffset(const RaptorObjectInfo* oti, int sbn) {
+    uint64_t t = (uint64_t)oti->T;
+    if (sbn < oti->ZL) {
+        return (uint64_t)sbn * oti->KL * t;
+    }
+    return ((uint64_t)oti->ZL * oti->KL + (uint64_t)(sbn - oti->ZL) * oti->KS) * t;
+}
+
+// 하위 블록 j의 하위 기호 크기와 기호 안에서의 위치 (바이트)
+static int sub_symbol_size(const RaptorObjectInfo* oti, int j) {
+    return (j < oti->NL ? oti->TL : oti->TS) * oti->Al;
+}
+
+static int sub_symbol_offset(const RaptorObjectInfo* oti, int j) {
+    if (j < oti->NL) {
+        return j * oti->TL * oti->Al;
+    }
+    return (oti->NL * oti->TL + (j - oti->NL) * oti->TS) * oti->Al;
+}
+
+// 하위 블록이 하나이고 블록 전체가 객체 안에 있으면 원본 블록은 객체의 연속된
+// 구간 그대로입니다. 이때는 모으고 흩는 복사 없이 객체(파일 매핑일 수 있음)를
+// 직접 읽고 씁니다.
+static bool contiguous_block(const RaptorObjectInfo* oti, int sbn) {
+    uint64_t end = SourceBlockOffset(oti, sbn) + (uint64_t)SourceBlockSymbols(oti, sbn) * oti->T;
+    return oti->N == 1 && end <= oti->F;
+}
+
+// 하위 블록 j를 이루는 K개의 하위 기호를 buf에 이어서 모읍니다. 객체 끝을
+// 넘는 부분은 0입니다.
+static void gather_sub_block(const RaptorObjectInfo* oti, const uint8_t* object, int sbn, int j, uint8_t* buf) {
+    int k = SourceBlockSymbols(oti, sbn);
+    int size = sub_symbol_size(oti, j);
+    uint64_t pos = SourceBlockOffset(oti, sbn) + sub_symbol_offset(oti, j);
+    for (int i = 0; i < k; i++, pos += oti->T) {
+        uint64_t avail = pos < oti->F ? oti->F - pos : 0;
+        int n = avail < (uint64_t)size ? (int)avail : size;
+        memcpy(buf + (size_t)i * size, object + pos, n);
+        memset(buf + (size_t)i * size + n, 0, size - n);
+    }
+}
+
+// gather_sub_block의 반대. 객체 끝을 넘는 부분은 버립니다.
+static void scatter_sub_block(const RaptorObjectInfo* oti, const uint8_t* buf, int sbn, int j, uint8_t* object) {
+    int k = SourceBlockSymbols(oti, sbn);
+    int size = sub_symbol_size(oti, j);
+    uint64_t pos = SourceBlockOffset(oti, sbn) + sub_symbol_offset(oti, j);
+    for (int i = 0; i < k; i++, pos += oti->T) {
+        uint64_t avail = pos < oti->F ? oti->F - pos : 0;
+        int n = avail < (uint64_t)size ? (int)avail : size;
+        memcpy(object + pos, buf + (size_t)i * size, n);
+    }
+}
+
+// 원본 블록 sbn에서 esis의 기호를 output에 이어서 씁니다 (기호마다 T바이트).
+// 하위 블록을 하나씩 인코딩하므로 한 번에 잡는 메모리는 하위 블록 하나의
+// 중간 기호 정도입니다. 기호 i는 각 하위 블록의 i번째 하위 기호를 이어 붙인
+// 것입니다. object는 읽기만 합니다. 중간 기호를 풀지 못하면 false를 반환합니다.
+bool EncodeRaptorSourceBlock(const RaptorObjectInfo* oti, const uint8_t* object, int sbn, const uint16_t* esis, int numEsis, uint8_t* output) {
+    int k = SourceBlockSymbols(oti, sbn);
+    bool direct = contiguous_block(oti, sbn);
+    uint8_t* buf = direct ? NULL : (uint8_t*)malloc((size_t)k * oti->TL * oti->Al);
+    raptor_params params;
+    raptor_params_init(&params, k);
+
+    bool ok = true;
+    for (int j = 0; j < oti->N && ok; j++) {
+        int size = sub_symbol_size(oti, j);
+        int offset = sub_symbol_offset(oti, j);
+        const uint8_t* sub = direct ? object + SourceBlockOffset(oti, sbn) : buf;
+        if (!direct) {
+            gather_sub_block(oti, object, sbn, j, buf);
+        }
+        symbolMatrix* intermediate = generate_intermediate_blocks(&params, sub, k * size, oti->Al);
+        ok = intermediate != NULL;
+        for (int i = 0; i < numEsis && ok; i++) {
+            lt_encode(&params, esis[i], intermediate, output + (size_t)i * oti->T + offset);
+        }
+        freeSymbolMatrix(intermediate);
+    }
+    free(buf);
+    return ok;
+}
+
+// 하위 블록 j를 푼 디코더에서 결과를 object의 제자리에 씁니다. 하위 블록이 블록
+// 전체이면 object에 바로 풀고, 아니면 decoded(k x 하위 기호 크기)에 풀어 흩습니다.
+static bool decode_sub_block(const RaptorObjectInfo* oti, int sbn, int j, void* decoder, uint8_t* decoded, uint8_t* object) {
+    if (contiguous_block(oti, sbn)) {
+        return decode_into(decoder, object + SourceBlockOffset(oti, sbn));
+    }
+    if (!decode_into(decoder, decoded)) {
+        return false;
+    }
+    scatter_sub_block(oti, decoded, sbn, j, object);
+    return true;
+}
+
+static void init_block_codec(const RaptorObjectInfo* oti, int k, RaptorCodec* codec) {
+    codec->NumSourceSymbols = k;
+    codec->SymbolAlignmentSize = oti->Al;
+    raptor_params_init(&codec->params, k);
+}
+
+// 원본 블록 sbn에 속한 기호들로 그 블록을 디코딩해 object의 제자리에 씁니다.
+// symbols의 sbn은 보지 않습니다. 하위 블록을 하나씩 풀기 때문에 디코더 메모리는
+// 받은 기호 수 x 하위 기호 크기로 묶입니다. 기호를 한꺼번에 모을 수 없으면
+// RaptorBlockDecoder로 받는 대로 넣습니다.
+bool DecodeRaptorSourceBlock(const RaptorObjectInfo* oti, int sbn, const ObjectSymbol* symbols, int numSymbols, uint8_t* object) {
+    int k = SourceBlockSymbols(oti, sbn);
+    size_t maxSize = (size_t)oti->TL * oti->Al;
+    uint16_t* esis = (uint16_t*)malloc(numSymbols * sizeof(uint16_t));
+    uint8_t* received = (uint8_t*)malloc(numSymbols * maxSize);
+    uint8_t* decoded = contiguous_block(oti, sbn) ? NULL : (uint8_t*)malloc(k * maxSize);
+    for (int i = 0; i < numSymbols; i++) {
+        esis[i] = symbols[i].esi;
+    }
+
+    RaptorCodec codec;
+    init_block_codec(oti, k, &codec);
+
+    bool ok = true;
+    for (int j = 0; j < oti->N && ok; j++) {
+        int size = sub_symbol_size(oti, j);
+        int offset = sub_symbol_offset(oti, j);
+        for (int i = 0; i < numSymbols; i++) {
+            memcpy(received + (size_t)i * size, symbols[i].data + offset, size);
+        }
+        void* decoder = new_decoder(&codec, k * size);
+        ok = add_blocks(decoder, esis, received, numSymbols) && decode_sub_block(oti, sbn, j, decoder, decoded, object);
+        destroy_raptor_decoder(decoder);
+    }
+
+    free(decoded);
+    free(received);
+    free(esis);
+    return ok;
+}
+
+// 원본 블록 sbn의 스트리밍 디코더 생성. 하위 블록마다 R10 디코더를 하나씩 둡니다.
+// oti는 디코더보다 오래 살아야 합니다.
+RaptorBlockDecoder* NewRaptorBlockDecoder(const RaptorObjectInfo* oti, int sbn) {
+    RaptorBlockDecoder* decoder = (RaptorBlockDecoder*)malloc(sizeof(RaptorBlockDecoder));
+    int k = SourceBlockSymbols(oti, sbn);
+    decoder->oti = oti;
+    decoder->sbn = sbn;
+    init_block_codec(oti, k, &decoder->codec);
+    decoder->subDecoders = (void**)malloc(oti->N * sizeof(void*));
+    for (int j = 0; j < oti->N; j++) {
+        decoder->subDecoders[j] = new_decoder(&decoder->codec, k * sub_symbol_size(oti, j));
+    }
+    decoder->remaining = oti->N;
+    return decoder;
+}
+
+// 원본 블록 sbn의 기호 numSymbols개를 넣습니다. 기호의 sbn은 보지 않고, 데이터는
+// 디코더가 복사하므로 돌아온 뒤 바로 해제해도 됩니다. 모든 하위 블록에 풀이를
+// 시도할 만큼 방정식이 모였으면 true를 반환합니다.
+bool AddRaptorBlockSymbols(RaptorBlockDecoder* decoder, const ObjectSymbol* symbols, int numSymbols) {
+    const RaptorObjectInfo* oti = decoder->oti;
+    uint16_t* esis = (uint16_t*)malloc((numSymbols > 0 ? numSymbols : 1) * sizeof(uint16_t));
+    uint8_t* received = (uint8_t*)malloc((numSymbols > 0 ? numSymbols : 1) * (size_t)oti->TL * oti->Al);
+    for (int i = 0; i < numSymbols; i++) {
+        esis[i] = symbols[i].esi;
+    }
+
+    bool ready = true;
+    for (int j = 0; j < oti->N; j++) {
+        if (decoder->subDecoders[j] == NULL) {
+            continue;
+        }
+        int size = sub_symbol_size(oti, j);
+        int offset = sub_symbol_offset(oti, j);
+        for (int i = 0; i < numSymbols; i++) {
+            memcpy(received + (size_t)i * size, symbols[i].data + offset, size);
+        }
+        ready = add_blocks(decoder->subDecoders[j], esis, received, numSymbols) && ready;
+    }
+    free(received);
+    free(esis);
+    return ready;
+}
+
+// 아직 풀리지 않은 하위 블록을 풀어 object의 제자리에 씁니다. 풀린 하위 블록의
+// 디코더는 바로 해제하므로 실패하면 기호를 더 넣고 다시 부르면 됩니다. 블록
+// 전체가 풀렸으면 true를 반환합니다.
+bool DecodeRaptorBlockInto(RaptorBlockDecoder* decoder, uint8_t* object) {
+    const RaptorObjectInfo* oti = decoder->oti;
+    int sbn = decoder->sbn;
+    int k = SourceBlockSymbols(oti, sbn);
+    uint8_t* decoded = contiguous_block(oti, sbn) ? NULL : (uint8_t*)malloc((size_t)k * oti->TL * oti->Al);
+    for (int j = 0; j < oti->N; j++) {
+        void* sub = decoder->subDecoders[j];
+        if (sub != NULL && decode_sub_block(oti, sbn, j, sub, decoded, object)) {
+            destroy_raptor_decoder(sub);
+            decoder->subDecoders[j] = NULL;
+            decoder->remaining--;
+        }
+    }
+    free(decoded);
+    return decoder->remaining == 0;
+}
+
+void FreeRaptorBlockDecoder(RaptorBlockDecoder* decoder) {
+    if (decoder != NULL) {
+        for (int j = 0; j < decoder->oti->N; j++) {
+            destroy_raptor_decoder(decoder->subDecoders[j]);
+        }
+        free(decoder->subDecoders);
+        free(decoder);
+    }
+}
+
+// 원본 블록 단위로 스레드에 나누는 작업
+typedef struct {
+    const RaptorObjectInfo* oti;
+    const uint8_t* object;
+    const uint16_t* esis;
+    int numEsis;
+    uint8_t* output;
+    bool* ok;
+} objectEncodeJob;
+
+static void encodeBlockRange(void* arg, int begin, int end) {
+    objectEncodeJob* job = (objectEncodeJob*)arg;
+    for (int sbn = begin; sbn < end; sbn++) {
+        uint8_t* out = job->output + (size_t)sbn * job->numEsis * job->oti->T;
+        job->ok[sbn] = EncodeRaptorSourceBlock(job->oti, job->object, sbn, job->esis, job->numEsis, out);
+    }
+}
+
+// 모든 원본 블록에서 esis의 기호를 인코딩합니다. 블록 sbn의 i번째 기호는
+// output + (sbn * numEsis + i) * T에 놓입니다. 블록마다 독립적이라 pool의
+// 스레드에 블록 단위로 나눕니다 (pool이 NULL이면 호출 스레드). 모든 블록이
+// 인코딩되어야 true입니다.
+bool EncodeRaptorObject(const RaptorObjectInfo* oti, const uint8_t* object, const uint16_t* esis, int numEsis, uint8_t* output, threadPool* pool) {
+    bool* ok = (bool*)calloc(oti->Z, sizeof(bool));
+    objectEncodeJob job = {oti, object, esis, numEsis, output, ok};
+    threadPoolFor(pool, oti->Z, 1, encodeBlockRange, &job);
+
+    bool all = true;
+    for (int sbn = 0; sbn < oti->Z; sbn++) {
+        all = all && ok[sbn];
+    }
+    free(ok);
+    return all;
+}
+
+typedef struct {
+    const RaptorObjectInfo* oti;
+    const ObjectSymbol* symbols;  // 원본 블록 번호 순으로 정렬됨
+    const int* start;             // 블록 sbn의 기호는 symbols[start[sbn]..start[sbn+1])
+    uint8_t* object;
+    bool* ok;
+} objectDecodeJob;
+
+static void decodeBlockRange(void* arg, int begin, int end) {
+    objectDecodeJob* job = (objectDecodeJob*)arg;
+    for (int sbn = begin; sbn < end; sbn++) {
+        const ObjectSymbol* s = job->symbols + job->start[sbn];
+        int n = job->start[sbn + 1] - job->start[sbn];
+        job->ok[sbn] = DecodeRaptorSourceBlock(job->oti, sbn, s, n, job->object);
+    }
+}
+
+// 받은 기호들로 객체 전체를 object(F 바이트)에 디코딩합니다. 기호를 원본 블록별로
+// 모은 뒤 블록 단위로 pool의 스레드에 나눕니다. 모든 블록이 풀려야 true입니다.
+// 객체의 모든 기호가 한꺼번에 메모리에 있어야 하므로, 큰 객체를 받는 쪽은 기호를
+// sbn별로 나눠 블록마다 RaptorBlockDecoder에 넣는 편이 낫습니다.
+bool DecodeRaptorObject(const RaptorObjectInfo* oti, const ObjectSymbol* symbols, int numSymbols, uint8_t* object, threadPool* pool) {
+    int* start = (int*)calloc(oti->Z + 1, sizeof(int));
+    for (int i = 0; i < numSymbols; i++) {
+        if (symbols[i].sbn >= 0 && symbols[i].sbn < oti->Z) {
+            start[symbols[i].sbn + 1]++;
+        }
+    }
+    for (int sbn = 0; sbn < oti->Z; sbn++) {
+        start[sbn + 1] += start[sbn];
+    }
+    ObjectSymbol* sorted = (ObjectSymbol*)malloc((start[oti->Z] > 0 ? start[oti->Z] : 1) * sizeof(ObjectSymbol));
+    int* fill = (int*)malloc(oti->Z * sizeof(int));
+    memcpy(fill, start, oti->Z * sizeof(int));
+    for (int i = 0; i < numSymbols; i++) {
+        if (symbols[i].sbn >= 0 && symbols[i].sbn < oti->Z) {
+            sorted[fill[symbols[i].sbn]++] = symbols[i];
+        }
+    }
+
+    bool* ok = (bool*)calloc(oti->Z, sizeof(bool));
+    objectDecodeJob job = {oti, sorted, start, object, ok};
+    threadPoolFor(pool, oti->Z, 1, decodeBlockRange, &job);
+
+    bool all = true;
+    for (int sbn = 0; sbn < oti->Z; sbn++) {
+        all = all && ok[sbn];
+    }
+    free(ok);
+    free(fill);
+    free(sorted);
+    free(start);
+    return all;
+}
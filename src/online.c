@@ -2,12 +2,9 @@
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
-
-// CDF 계산 함수 (샘플 함수)
-double* calculate_cdf(double epsilon) {
-    // CDF 계산 로직 구현
-    return NULL;
-}
+#include "prng.h"
+#include "sample.h"
+#include "xor.h"
 
 online_codec* create_online_codec(int sourceBlocks, double epsilon, int quality, int64_t seed) {
     online_codec* codec = (online_codec*)malloc(sizeof(online_codec));
@@ -15,13 +12,13 @@ online_codec* create_online_codec(int sourceBlocks, double epsilon, int quality,
     codec->quality = quality;
     codec->numSourceBlocks = sourceBlocks;
     codec->randomSeed = seed;
-    codec->cdf = calculate_cdf(epsilon);
+    codec->degrees = acquireOnlineSoliton(epsilon);
     return codec;
 }
 
 void destroy_online_codec(online_codec* codec) {
     if (codec != NULL) {
-        free(codec->cdf);
+        releaseDegreeDist(codec->degrees);
         free(codec);
     }
 }
@@ -38,4 +35,210 @@ int estimate_decode_blocks_needed(const online_codec* codec) {
     return (int)ceil((1 + codec->epsilon) * (codec->numSourceBlocks + num_aux_blocks(codec)));
 }
 
-// 여기에 `generate_intermediate_blocks`와 `encode_online_blocks` 구현 추가
+// 원본 블록 i가 더해지는 보조 블록들을 aux에 씁니다 (최대 quality개, 서로 다름).
+// 검사 블록과 수열이 겹치지 않도록 시드를 한 번 섞은 키를 씁니다.
+static int aux_blocks_of(const online_codec* codec, int numAux, int i, int* aux) {
+    counterRng rng;
+    counterRngInit(&rng, splitmix64((uint64_t)codec->randomSeed), i);
+    unsigned int seed = (unsigned int)counterRngNext(&rng);
+    return sampleUniformInto(&seed, codec->quality, numAux, aux, false);
+}
+
+// 검사 블록 하나가 포함하는 합성 블록(원본 + 보조)의 인덱스를 indices에 쓰고
+// 개수를 돌려줍니다. indices는 원본 블록 수 + 보조 블록 수만큼의 int를 담아야 합니다.
+// (시드, 블록 ID)만으로 정해지므로 어느 스레드에서 불러도 같은 결과가 나옵니다.
+int online_pick_indices(const online_codec* codec, int64_t codeBlockIndex, int* indices) {
+    counterRng rng;
+    counterRngInit(&rng, (uint64_t)codec->randomSeed, codeBlockIndex);
+    double u = (double)(counterRngNext(&rng) >> 11) * 0x1.0p-53;
+    int degree = aliasSample(codec->degrees->table, u);
+    unsigned int seed = (unsigned int)counterRngNext(&rng);
+    return sampleUniformInto(&seed, degree, codec->numSourceBlocks + num_aux_blocks(codec), indices, false);
+}
+
+// 메시지를 numSourceBlocks개의 원본 블록으로 나눴을 때 블록 i의 시작과 길이.
+// 앞쪽 numLong개는 한 바이트 긴 블록입니다 (partitionSymbols와 같은 배치).
+typedef struct {
+    int longSize, shortSize, numLong;
+} sourceLayout;
+
+static sourceLayout source_layout(const online_codec* codec, size_t message_len) {
+    int n = codec->numSourceBlocks;
+    sourceLayout layout;
+    layout.shortSize = (int)(message_len / n);
+    layout.numLong = (int)(message_len - (size_t)layout.shortSize * n);
+    layout.longSize = layout.numLong > 0 ? layout.shortSize + 1 : layout.shortSize;
+    return layout;
+}
+
+static const uint8_t* source_block(const sourceLayout* layout, const uint8_t* message, int i) {
+    if (i < layout->numLong) {
+        return message + (size_t)i * layout->longSize;
+    }
+    return message + (size_t)layout->numLong * layout->longSize + (size_t)(i - layout->numLong) * layout->shortSize;
+}
+
+// 보조 블록 행렬(보조 블록 수 x 블록 길이)을 만듭니다. 원본 블록은 복사하지 않고
+// 메시지에서 바로 읽어 그 블록이 속한 quality개의 보조 블록에 XOR합니다. 짧은
+// 블록의 빠진 마지막 바이트는 0으로 봅니다.
+symbolMatrix* generate_intermediate_blocks(const online_codec* codec, const uint8_t* message, size_t message_len) {
+    int n = codec->numSourceBlocks;
+    int numAux = num_aux_blocks(codec);
+    sourceLayout layout = source_layout(codec, message_len);
+
+    symbolMatrix* blocks = newSymbolMatrix(numAux, layout.longSize, 1);
+    int* aux = (int*)malloc((codec->quality > 0 ? codec->quality : 1) * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        int size = i < layout.numLong ? layout.longSize : layout.shortSize;
+        const uint8_t* src = source_block(&layout, message, i);
+        int count = aux_blocks_of(codec, numAux, i, aux);
+        for (int j = 0; j < count; j++) {
+            xorBytes(symbolAt(blocks, aux[j]), src, size);
+        }
+    }
+    free(aux);
+    return blocks;
+}
+
+// 메시지와 보조 블록에서 ids의 검사 블록들을 output에 이어서 씁니다. 블록 길이를
+// 돌려줍니다. 원본 블록은 메시지에서 바로 읽습니다. 길이가 나누어떨어지지 않으면
+// 짧은 블록 길이만큼 한 번에 XOR하고, 마지막 바이트는 긴 블록과 보조 블록에서만
+// 따로 모읍니다 (짧은 블록의 채움 바이트는 0).
+size_t encode_online_blocks(const online_codec* codec, const uint8_t* message, size_t message_len, const symbolMatrix* aux, const int64_t* ids, int num_ids, uint8_t* output) {
+    int n = codec->numSourceBlocks;
+    int total = n + aux->count;
+    sourceLayout layout = source_layout(codec, message_len);
+    size_t size = layout.longSize;
+    const uint8_t** srcs = (const uint8_t**)malloc(total * sizeof(uint8_t*));
+    int* indices = (int*)malloc(total * sizeof(int));
+    for (int i = 0; i < num_ids; i++) {
+        uint8_t* out = output + (size_t)i * size;
+        int count = online_pick_indices(codec, ids[i], indices);
+        for (int j = 0; j < count; j++) {
+            int idx = indices[j];
+            srcs[j] = idx < n ? source_block(&layout, message, idx) : symbolAt(aux, idx - n);
+        }
+        if (layout.numLong == 0) {
+            xorBytesGather(out, srcs, count, size);
+            continue;
+        }
+        xorBytesGather(out, srcs, count, layout.shortSize);
+        uint8_t last = 0;
+        for (int j = 0; j < count; j++) {
+            if (indices[j] < layout.numLong || indices[j] >= n) {
+                last ^= srcs[j][layout.shortSize];
+            }
+        }
+        out[layout.shortSize] = last;
+    }
+    free(indices);
+    free(srcs);
+    return size;
+}
+
+// 디코더 생성. 보조 블록마다 "속한 원본 블록들 ^ 보조 블록 = 0" 제약을 먼저
+// 넣습니다. 검사 블록은 대부분 벗겨내기(peeling)만으로 풀리고, 막힌 부분만
+// 비활성화 소거로 넘어갑니다.
+online_decoder* new_online_decoder(const online_codec* codec, int message_length) {
+    online_decoder* decoder = (online_decoder*)malloc(sizeof(online_decoder));
+    int n = codec->numSourceBlocks;
+    int numAux = num_aux_blocks(codec);
+    decoder->codec = codec;
+    decoder->message_length = message_length;
+    decoder->symbol_size = (message_length + n - 1) / n;
+    decoder->num_aux = numAux;
+    decoder->matrix = new_inactivation_decoder(n + numAux, decoder->symbol_size);
+    if (numAux == 0) {
+        return decoder;
+    }
+
+    // 보조 블록별 구성을 CSR 형태로 모읍니다.
+    int quality = codec->quality > 0 ? codec->quality : 1;
+    int* picks = (int*)malloc((size_t)n * quality * sizeof(int));
+    int* counts = (int*)malloc(n * sizeof(int));
+    int* start = (int*)calloc(numAux + 1, sizeof(int));
+    for (int i = 0; i < n; i++) {
+        counts[i] = aux_blocks_of(codec, numAux, i, picks + (size_t)i * quality);
+        for (int j = 0; j < counts[i]; j++) {
+            start[picks[(size_t)i * quality + j] + 1]++;
+        }
+    }
+    for (int a = 0; a < numAux; a++) {
+        start[a + 1] += start[a];
+    }
+    int* members = (int*)malloc((start[numAux] + numAux) * sizeof(int));
+    int* fill = (int*)malloc(numAux * sizeof(int));
+    for (int a = 0; a < numAux; a++) {
+        fill[a] = start[a] + a;
+    }
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < counts[i]; j++) {
+            int a = picks[(size_t)i * quality + j];
+            members[fill[a]++] = i;
+        }
+    }
+    for (int a = 0; a < numAux; a++) {
+        int* row = members + start[a] + a;
+        int len = fill[a] - (start[a] + a);
+        row[len++] = n + a;
+        inactivation_add_row(decoder->matrix, row, len, NULL);
+    }
+
+    free(fill);
+    free(members);
+    free(start);
+    free(counts);
+    free(picks);
+    return decoder;
+}
+
+void destroy_online_decoder(online_decoder* decoder) {
+    if (decoder != NULL) {
+        destroy_inactivation_decoder(decoder->matrix);
+        free(decoder);
+    }
+}
+
+// 검사 블록 numBlocks개(blocks에 이어서 저장)를 추가합니다. 미지수 수만큼
+// 방정식이 모이면 1을 돌려줍니다. 풀이가 실패하면 블록을 더 넣으면 됩니다.
+int online_add_blocks(online_decoder* decoder, const int64_t* ids, const uint8_t* blocks, int numBlocks) {
+    STATS_TIMER(t0);
+    int* indices = (int*)malloc(decoder->matrix->num_cols * sizeof(int));
+    for (int i = 0; i < numBlocks; i++) {
+        int count = online_pick_indices(decoder->codec, ids[i], indices);
+        inactivation_add_row(decoder->matrix, indices, count, blocks + (size_t)i * decoder->symbol_size);
+    }
+    free(indices);
+    STATS_ELAPSED(&decoder->matrix->stats, addNanos, t0);
+    return decoder->matrix->num_rows >= decoder->matrix->num_cols;
+}
+
+// symbolBufferSize(message_length, numSourceBlocks) 바이트 이상의 호출자 버퍼에
+// 복호화합니다. 합성 블록의 앞부분이 곧 원본 블록이므로 한 번 복사하고 그 자리에서
+// 채움 바이트를 걷어냅니다.
+bool online_decode_into(online_decoder* decoder, uint8_t* out) {
+    int n = decoder->codec->numSourceBlocks;
+    symbolMatrix* composite = newSymbolMatrix(decoder->matrix->num_cols, decoder->symbol_size, 1);
+    if (!inactivation_solve(decoder->matrix, composite)) {
+        freeSymbolMatrix(composite);
+        return false;
+    }
+
+    memcpy(out, composite->data, (size_t)n * decoder->symbol_size);
+    symbolMatrix* source = viewSymbols(out, n, decoder->symbol_size);
+    compactSymbols(source, n, decoder->message_length);
+    freeSymbolMatrix(source);
+    freeSymbolMatrix(composite);
+    return true;
+}
+
+uint8_t* online_decode(online_decoder* decoder, int* out_length) {
+    uint8_t* out = (uint8_t*)malloc(symbolBufferSize(decoder->message_length, decoder->codec->numSourceBlocks));
+    if (!online_decode_into(decoder, out)) {
+        free(out);
+        return NULL;
+    }
+
+    *out_length = decoder->message_length;
+    return out;
+}
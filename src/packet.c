@@ -0,0 +1,199 @@
+#include <string.h>
+#include <pthread.h>
+#include "packet.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define PACKET_X86_64 1
+#endif
+
+typedef uint32_t (*crcKernel)(uint32_t, const uint8_t*, size_t);
+
+// CRC-32C (Castagnoli, reflected polynomial 0x82F63B78), one byte per step
+static uint32_t crcTable[256];
+
+static uint32_t crc32c_Table(uint32_t crc, const uint8_t* p, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        crc = crcTable[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#ifdef PACKET_X86_64
+
+// The SSE4.2 crc32 instruction computes the same CRC-32C, eight bytes at a time.
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_SSE42(uint32_t crc, const uint8_t* p, size_t length) {
+    uint64_t c = crc;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, 8);
+        c = _mm_crc32_u64(c, w);
+    }
+    crc = (uint32_t)c;
+    for (; i < length; i++) {
+        crc = _mm_crc32_u8(crc, p[i]);
+    }
+    return crc;
+}
+
+#endif // PACKET_X86_64
+
+static crcKernel selectedKernel = crc32c_Table;
+static const char* selectedKernelName = "table";
+static pthread_once_t kernelOnce = PTHREAD_ONCE_INIT;
+
+// Fills the table and picks the hardware CRC when the CPU has it.
+static void selectKernel(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c >> 1) ^ (c & 1 ? 0x82F63B78u : 0);
+        }
+        crcTable[i] = c;
+    }
+#ifdef PACKET_X86_64
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        selectedKernel = crc32c_SSE42;
+        selectedKernelName = "sse4.2";
+    }
+#endif
+}
+
+// Checksum of a packet: the fixed header, then the payload
+static uint32_t packetChecksum(const uint8_t* header, const uint8_t* payload, size_t payloadLength) {
+    pthread_once(&kernelOnce, selectKernel);
+    uint32_t crc = selectedKernel(0xFFFFFFFFu, header, PACKET_HEADER_SIZE);
+    crc = selectedKernel(crc, payload, payloadLength);
+    return ~crc;
+}
+
+static void put16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static void put32(uint8_t* p, uint32_t v) {
+    put16(p, (uint16_t)(v >> 16));
+    put16(p + 2, (uint16_t)v);
+}
+
+static void put64(uint8_t* p, uint64_t v) {
+    put32(p, (uint32_t)(v >> 32));
+    put32(p + 4, (uint32_t)v);
+}
+
+static uint16_t get16(const uint8_t* p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static uint32_t get32(const uint8_t* p) {
+    return ((uint32_t)get16(p) << 16) | get16(p + 2);
+}
+
+static uint64_t get64(const uint8_t* p) {
+    return ((uint64_t)get32(p) << 32) | get32(p + 4);
+}
+
+// Bytes one packet with a payload of symbolSize bytes occupies on the wire.
+size_t PacketSize(size_t symbolSize, bool checksum) {
+    return PACKET_HEADER_SIZE + (checksum ? PACKET_CHECKSUM_SIZE : 0) + symbolSize;
+}
+
+// Writes the header and payload of block into buffer. Returns the number of
+// bytes written, or 0 if the packet does not fit in capacity bytes or the
+// payload is too long for the 32-bit size field.
+size_t WritePacket(uint8_t* buffer, size_t capacity, uint16_t sourceBlock, const LTBlock* block, bool checksum) {
+    size_t size = PacketSize(block->length, checksum);
+    if (size > capacity || block->length > UINT32_MAX) {
+        return 0;
+    }
+    buffer[0] = PACKET_VERSION;
+    buffer[1] = checksum ? PACKET_FLAG_CHECKSUM : 0;
+    put16(buffer + 2, sourceBlock);
+    put32(buffer + 4, (uint32_t)block->length);
+    put64(buffer + 8, (uint64_t)block->blockCode);
+    uint8_t* payload = buffer + PACKET_HEADER_SIZE;
+    if (checksum) {
+        payload += PACKET_CHECKSUM_SIZE;
+    }
+    memcpy(payload, block->data, block->length);
+    if (checksum) {
+        put32(buffer + PACKET_HEADER_SIZE, packetChecksum(buffer, payload, block->length));
+    }
+    return size;
+}
+
+// Writes numBlocks packets back to back, for example as the iovecs of one
+// sendmmsg call. offsets, if not NULL, receives where each packet starts.
+// Returns the total number of bytes written, or 0 if they do not all fit.
+size_t WritePackets(uint8_t* buffer, size_t capacity, uint16_t sourceBlock, const LTBlock* blocks, int numBlocks, bool checksum, size_t* offsets) {
+    size_t used = 0;
+    for (int i = 0; i < numBlocks; i++) {
+        size_t n = WritePacket(buffer + used, capacity - used, sourceBlock, &blocks[i], checksum);
+        if (n == 0) {
+            return 0;
+        }
+        if (offsets) {
+            offsets[i] = used;
+        }
+        used += n;
+    }
+    return used;
+}
+
+// Parses the packet at the start of buffer. On PACKET_OK, block points into
+// buffer (nothing is copied, so buffer must outlive the block) and info, if not
+// NULL, holds the remaining header fields. The buffer may continue past the
+// packet; info->size tells where the next one starts.
+packetStatus ParsePacket(const uint8_t* buffer, size_t length, packetInfo* info, LTBlock* block) {
+    if (length < PACKET_HEADER_SIZE) {
+        return PACKET_TRUNCATED;
+    }
+    if (buffer[0] != PACKET_VERSION || (buffer[1] & ~PACKET_FLAG_CHECKSUM) != 0) {
+        return PACKET_BAD_VERSION;
+    }
+    bool checksum = (buffer[1] & PACKET_FLAG_CHECKSUM) != 0;
+    size_t symbolSize = get32(buffer + 4);
+    size_t size = PacketSize(symbolSize, checksum);
+    if (length < size) {
+        return PACKET_TRUNCATED;
+    }
+    const uint8_t* payload = buffer + size - symbolSize;
+    if (checksum && get32(buffer + PACKET_HEADER_SIZE) != packetChecksum(buffer, payload, symbolSize)) {
+        return PACKET_BAD_CHECKSUM;
+    }
+
+    block->blockCode = (int64_t)get64(buffer + 8);
+    block->data = (uint8_t*)payload;
+    block->length = symbolSize;
+    if (info) {
+        info->sourceBlock = get16(buffer + 2);
+        info->checksummed = checksum;
+        info->size = size;
+    }
+    return PACKET_OK;
+}
+
+// Parses one datagram per buffer (as filled by recvmmsg) and keeps the valid
+// packets of sourceBlock, in order, as views in blocks. Packets that fail to
+// parse or belong to another source block are skipped. Returns the number of
+// blocks written.
+int ParsePackets(const uint8_t* const* buffers, const size_t* lengths, int numPackets, uint16_t sourceBlock, LTBlock* blocks) {
+    int n = 0;
+    for (int i = 0; i < numPackets; i++) {
+        packetInfo info;
+        if (ParsePacket(buffers[i], lengths[i], &info, &blocks[n]) == PACKET_OK && info.sourceBlock == sourceBlock) {
+            n++;
+        }
+    }
+    return n;
+}
+
+// Name of the selected checksum kernel ("sse4.2" or "table")
+const char* packetChecksumKernelName(void) {
+    pthread_once(&kernelOnce, selectKernel);
+    return selectedKernelName;
+}
@@ -0,0 +1,146 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "pool.h"
+
+// threadPool 구조체: 미리 띄워 둔 작업 스레드들. threadPoolFor 한 번이 하나의
+// 작업(generation)이고, 스레드들은 [0, n)을 grain 크기 조각으로 나눠 가져갑니다.
+// 호출한 스레드도 함께 일하며, 모든 조각이 끝나야 반환합니다.
+struct threadPool {
+    pthread_t* threads;
+    int numThreads;        // 작업 스레드 수 (호출 스레드 제외)
+    pthread_mutex_t lock;
+    pthread_cond_t start;  // 새 작업 알림
+    pthread_cond_t done;   // 작업 종료 알림
+    unsigned generation;   // 작업 번호
+    bool stop;
+
+    poolTask task;         // 현재 작업
+    void* arg;
+    int n;
+    int grain;
+    int next;              // 아직 나눠 주지 않은 첫 항목 (원자적으로 증가)
+    int finished;          // 현재 작업을 마친 작업 스레드 수
+};
+
+// 조각을 하나씩 가져가며 남은 항목이 없을 때까지 처리합니다.
+static void runChunks(threadPool* pool, poolTask task, void* arg, int n, int grain) {
+    for (;;) {
+        int begin = __atomic_fetch_add(&pool->next, grain, __ATOMIC_RELAXED);
+        if (begin >= n) {
+            return;
+        }
+        task(arg, begin, begin + grain < n ? begin + grain : n);
+    }
+}
+
+static void* worker(void* p) {
+    threadPool* pool = (threadPool*)p;
+    unsigned seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->stop && pool->generation == seen) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if (pool->stop) {
+            break;
+        }
+        seen = pool->generation;
+        poolTask task = pool->task;
+        void* arg = pool->arg;
+        int n = pool->n;
+        int grain = pool->grain;
+        pthread_mutex_unlock(&pool->lock);
+
+        runChunks(pool, task, arg, n, grain);
+
+        pthread_mutex_lock(&pool->lock);
+        if (++pool->finished == pool->numThreads) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// 스레드 풀 생성. numThreads가 0 이하이면 온라인 CPU 수만큼 일합니다
+// (호출 스레드 포함).
+threadPool* newThreadPool(int numThreads) {
+    if (numThreads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        numThreads = cpus > 0 ? (int)cpus : 1;
+    }
+
+    threadPool* pool = (threadPool*)calloc(1, sizeof(threadPool));
+    pool->numThreads = numThreads - 1;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    pool->threads = (pthread_t*)malloc((pool->numThreads > 0 ? pool->numThreads : 1) * sizeof(pthread_t));
+    for (int i = 0; i < pool->numThreads; i++) {
+        pthread_create(&pool->threads[i], NULL, worker, pool);
+    }
+    return pool;
+}
+
+void freeThreadPool(threadPool* pool) {
+    if (pool == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->numThreads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+    free(pool->threads);
+    free(pool);
+}
+
+// 호출 스레드를 포함한 전체 스레드 수
+int threadPoolSize(const threadPool* pool) {
+    return pool != NULL ? pool->numThreads + 1 : 1;
+}
+
+// [0, n)을 grain개씩 나눠 task를 병렬로 실행하고 모두 끝날 때까지 기다립니다.
+// pool이 NULL이거나 조각이 하나뿐이면 호출 스레드에서 바로 실행합니다.
+// 같은 풀에 대해 여러 스레드가 동시에 호출하면 안 됩니다.
+void threadPoolFor(threadPool* pool, int n, int grain, poolTask task, void* arg) {
+    if (n <= 0) {
+        return;
+    }
+    if (grain < 1) {
+        grain = 1;
+    }
+    if (pool == NULL || pool->numThreads == 0 || n <= grain) {
+        task(arg, 0, n);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->arg = arg;
+    pool->n = n;
+    pool->grain = grain;
+    pool->next = 0;
+    pool->finished = 0;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    runChunks(pool, task, arg, n, grain);
+
+    // 모든 작업 스레드가 이번 작업을 마쳐야 합니다. 늦게 깨어난 스레드가 다음
+    // 작업의 next를 보고 이번 task를 실행하는 일이 없도록 하기 위해서입니다.
+    pthread_mutex_lock(&pool->lock);
+    while (pool->finished < pool->numThreads) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
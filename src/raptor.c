@@ -1,8 +1,11 @@
 #include "raptor.h"
+#include "xor.h"
+#include "inactivation.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
 #include <string.h>
+#include "util.c"
 
 // RaptorCodec 생성 함수
 RaptorCodec* create_raptor_codec(int source_blocks, int alignment_size) {
@@ -10,6 +13,7 @@ RaptorCodec* create_raptor_codec(int source_blocks, int alignment_size) {
     if (codec) {
         codec->NumSourceSymbols = source_blocks;
         codec->SymbolAlignmentSize = alignment_size;
+        raptor_params_init(&codec->params, source_blocks);
     }
     return codec;
 }
@@ -21,13 +25,11 @@ void destroy_raptor_codec(RaptorCodec* codec) {
     }
 }
 
-// 랜덤 함수
+// 랜덤 함수 (RFC 5053 5.4.4.1)
 int raptor_rand(uint32_t x, uint32_t i, uint32_t m) {
-    static const uint8_t v0table[256] = { /* ... */ };
-    static const uint8_t v1table[256] = { /* ... */ };
-    uint8_t v0 = v0table[(x + i) % 256];
-    uint8_t v1 = v1table[((x / 256) + i) % 256];
-    return (v0 ^ v1) % m;
+    uint32_t v0 = v0table[(x + i) % 256];
+    uint32_t v1 = v1table[((x / 256) + i) % 256];
+    return (int)((v0 ^ v1) % m);
 }
 
 // 디그리 함수
@@ -49,102 +51,251 @@ void intermediate_symbols(int k, int* L, int* S, int* H) {
     while (x * (x - 1) < 2 * k) x++;
 
     *S = (int)ceil(0.01 * (double)k) + x;
-    // Here should be a function to find the smallest prime greater than or equal to *S
-    *S = smallest_prime_greater_or_equal(*S);
+    *S = smallestPrimeGreaterOrEqual(*S);
 
     *H = (int)floor(log((double)(*S + k)) / log(4));
-    while (center_binomial(*H) < *S + k) (*H)++;
+    while (centerBinomial(*H) < *S + k) (*H)++;
     *L = k + *S + *H;
 }
 
-// 트리플 생성기
-void triple_generator(int k, uint16_t x, int* d, uint32_t* a, uint32_t* b) {
-    int L, S, H;
-    intermediate_symbols(k, &L, &S, &H);
-    uint32_t lprime = smallest_prime_greater_or_equal(L);
-    uint32_t q = 65521;
-    uint32_t jk = systematic_index_table[k];
-    *a = (uint32_t)((53591 + (uint64_t)jk * 997) % q);
-    *b = (10267 * (jk + 1)) % q;
-    uint32_t y = (uint32_t)((*b + (uint64_t)x * *a) % q);
+// 체계적 인덱스 J와 그에 따른 트리플 생성기의 시드를 정합니다.
+static void set_systematic_index(raptor_params* p, uint32_t j) {
+    const uint32_t q = 65521;
+    p->J = j;
+    p->A = (uint32_t)((53591 + (uint64_t)j * 997) % q);
+    p->B = (10267 * (j + 1)) % q;
+}
+
+static void small_systematic_index(raptor_params* p);
+
+// K에만 의존하는 값들을 한 번에 계산합니다.
+void raptor_params_init(raptor_params* p, int k) {
+    p->K = k;
+    intermediate_symbols(k, &p->L, &p->S, &p->H);
+    p->Lprime = (uint32_t)smallestPrimeGreaterOrEqual(p->L);
+    if (k >= 4 && k <= MAX_SOURCE_SYMBOLS) {
+        set_systematic_index(p, systematicIndextable[k]);
+    } else if (k >= 1 && k < 4) {
+        small_systematic_index(p);
+    } else {
+        set_systematic_index(p, 0);
+    }
+}
+
+// 트리플 생성기 (RFC 5053 5.4.4.4)
+void triple_generator(const raptor_params* p, uint16_t x, int* d, uint32_t* a, uint32_t* b) {
+    const uint32_t q = 65521;
+    uint32_t y = (uint32_t)((p->B + (uint64_t)x * p->A) % q);
     uint32_t v = raptor_rand(y, 0, 1048576);
     *d = deg(v);
-    *a = 1 + raptor_rand(y, 1, lprime - 1);
-    *b = raptor_rand(y, 2, lprime);
+    *a = 1 + raptor_rand(y, 1, p->Lprime - 1);
+    *b = raptor_rand(y, 2, p->Lprime);
+}
+
+static int compare_int(const void* a, const void* b) {
+    return (*(const int*)a > *(const int*)b) - (*(const int*)a < *(const int*)b);
 }
 
-// LT 인덱스 찾기
-void find_lt_indices(int k, uint16_t x, int* indices, int* num_indices) {
-    int L, S, H;
-    intermediate_symbols(k, &L, &S, &H);
-    uint32_t lprime = (uint32_t)smallest_prime_greater_or_equal(L);
+// LT 인덱스 찾기 (RFC 5053 5.4.4.3)
+void find_lt_indices(const raptor_params* p, uint16_t x, int* indices, int* num_indices) {
+    int L = p->L;
+    uint32_t lprime = p->Lprime;
     int d;
     uint32_t a, b;
-    triple_generator(k, x, &d, &a, &b);
+    triple_generator(p, x, &d, &a, &b);
 
     if (d > L) d = L;
 
     int idx = 0;
-    while (b >= lprime) {
+    while (b >= (uint32_t)L) {
         b = (b + a) % lprime;
     }
     indices[idx++] = (int)b;
 
     for (int j = 1; j < d; j++) {
         b = (b + a) % lprime;
-        while (b >= lprime) {
+        while (b >= (uint32_t)L) {
             b = (b + a) % lprime;
         }
         indices[idx++] = (int)b;
     }
 
     *num_indices = idx;
-    // 정렬 함수 필요
     qsort(indices, *num_indices, sizeof(int), compare_int);
 }
 
-// LT 인코딩
-void lt_encode(int k, uint16_t x, const uint8_t* c, uint8_t* result) {
+// LT 인코딩: c의 중간 기호 중 x에 해당하는 것들을 XOR해 result에 씁니다.
+void lt_encode(const raptor_params* p, uint16_t x, const symbolMatrix* c, uint8_t* result) {
     int indices[MAX_SOURCE_SYMBOLS];
+    const uint8_t* srcs[MAX_SOURCE_SYMBOLS];
     int num_indices;
-    find_lt_indices(k, x, indices, &num_indices);
+    pick_indices(p, x, indices, &num_indices);
 
-    memset(result, 0, sizeof(result));
+    // 차수 d인 기호도 결과 버퍼를 한 번만 지나갑니다.
     for (int i = 0; i < num_indices; i++) {
-        // XOR 연산
-        xor_blocks(result, c[indices[i]]);
+        srcs[i] = symbolAt(c, indices[i]);
+    }
+    xorBytesGather(result, srcs, num_indices, c->symbolSize);
+}
+
+// RFC 5053의 J(K) 표는 4 <= K <= 8192만 정의합니다. K < 4에서는 ESI 0..K-1의 행과
+// 제약 방정식이 가역이 되는 가장 작은 J를 찾아 씁니다 (L이 작아 바로 끝납니다).
+// 값은 쓰지 않으므로 기호 크기 0으로 풉니다.
+static void small_systematic_index(raptor_params* p) {
+    int indices[MAX_SOURCE_SYMBOLS];
+    int num_indices;
+    symbolMatrix* scratch = newSymbolMatrix(p->L, 0, 1);
+    for (uint32_t j = 0;; j++) {
+        set_systematic_index(p, j);
+        inactivation_decoder* matrix = new_inactivation_decoder(p->L, 0);
+        inactivation_add_constraints(matrix, p->K, p->S, p->H);
+        for (int i = 0; i < p->K; i++) {
+            find_lt_indices(p, (uint16_t)i, indices, &num_indices);
+            inactivation_add_row(matrix, indices, num_indices, NULL);
+        }
+        bool ok = inactivation_solve(matrix, scratch);
+        destroy_inactivation_decoder(matrix);
+        if (ok) {
+            break;
+        }
     }
+    freeSymbolMatrix(scratch);
 }
 
-// 중간 블록 생성
-void raptor_intermediate_blocks(const uint8_t* source, int num_blocks, uint8_t* intermediate_blocks) {
-    // 인터페이스를 정의한 구조체를 사용하여 구현
+// 중간 블록 생성 (RFC 5053 5.4.2.4). ESI 0..K-1의 인코딩 기호가 원본 기호와 같도록
+// 중간 기호 L개를 정합니다. 제약 방정식에 "ESI i의 행 = 원본 기호 i" (i < K)를 더한
+// 시스템을 디코더와 같은 풀이기로 풉니다. J(K)가 이 시스템이 가역이 되도록 골라진
+// 값이므로 K <= MAX_SOURCE_SYMBOLS이면 항상 풀립니다 (K < 4는 small_systematic_index).
+// p는 source->count에 대한 값이어야 하고, 풀리지 않으면 false를 반환합니다.
+bool raptor_intermediate_blocks(const raptor_params* p, const symbolMatrix* source, symbolMatrix* intermediate_blocks) {
+    int indices[MAX_SOURCE_SYMBOLS];
+    int num_indices;
+
+    inactivation_decoder* matrix = new_inactivation_decoder(p->L, source->symbolSize);
+    inactivation_add_constraints(matrix, p->K, p->S, p->H);
+    for (int i = 0; i < p->K; i++) {
+        pick_indices(p, i, indices, &num_indices);
+        inactivation_add_row(matrix, indices, num_indices, symbolAt(source, i));
+    }
+    bool ok = inactivation_solve(matrix, intermediate_blocks);
+    destroy_inactivation_decoder(matrix);
+    return ok;
 }
 
-// 메시지와 블록 수로 중간 블록 생성
-void generate_intermediate_blocks(const uint8_t* message, int message_length, int num_blocks, uint8_t* blocks) {
-    // 메시지 분할 및 중간 블록 생성
+// 메시지를 p->K개의 원본 기호로 나눠 중간 블록 생성. 원본 기호는 정렬된 연속 메모리
+// 하나에 나눠 담습니다. 풀리지 않으면 NULL을 반환합니다.
+symbolMatrix* generate_intermediate_blocks(const raptor_params* p, const uint8_t* message, int message_length, int alignment) {
+    symbolMatrix* source = partitionSymbols(message, message_length, p->K, alignment);
+    symbolMatrix* intermediate = newSymbolMatrix(p->L, source->symbolSize, alignment);
+    if (!raptor_intermediate_blocks(p, source, intermediate)) {
+        freeSymbolMatrix(intermediate);
+        intermediate = NULL;
+    }
+    freeSymbolMatrix(source);
+    return intermediate;
 }
 
-// 인덱스 선택
-void pick_indices(int code_block_index, int* indices, int* num_indices) {
-    find_lt_indices(code_block_index, indices, num_indices);
+// 인덱스 선택: ESI의 인코딩 기호가 XOR하는 중간 기호 (원본 ESI도 LT 인덱스)
+void pick_indices(const raptor_params* p, int code_block_index, int* indices, int* num_indices) {
+    find_lt_indices(p, (uint16_t)code_block_index, indices, num_indices);
 }
 
-// 디코더 생성
+// 디코더 생성. LDPC와 Half 제약 방정식을 미리 넣어 둡니다.
 void* new_decoder(const RaptorCodec* codec, int message_length) {
-    // 디코더 생성 및 초기화
-    return NULL;
+    raptor_decoder* decoder = (raptor_decoder*)malloc(sizeof(raptor_decoder));
+    decoder->codec = *codec;
+    decoder->message_length = message_length;
+    int K = codec->NumSourceSymbols;
+    decoder->symbol_size = (message_length + K - 1) / K;
+    if (codec->params.K == K) {
+        decoder->params = codec->params;
+    } else {
+        raptor_params_init(&decoder->params, K);
+    }
+    raptor_params* p = &decoder->params;
+    decoder->matrix = new_inactivation_decoder(p->L, decoder->symbol_size);
+    inactivation_add_constraints(decoder->matrix, p->K, p->S, p->H);
+    decoder->source_rows = (int*)malloc(K * sizeof(int));
+    for (int i = 0; i < K; i++) {
+        decoder->source_rows[i] = -1;
+    }
+    decoder->num_source = 0;
+    return decoder;
+}
+
+// 디코더 해제
+void destroy_raptor_decoder(void* decoder) {
+    raptor_decoder* d = (raptor_decoder*)decoder;
+    if (d) {
+        destroy_inactivation_decoder(d->matrix);
+        free(d->source_rows);
+        free(d);
+    }
+}
+
+// 블록 추가. blocks에는 symbol_size 간격으로 num_blocks개의 기호가 있고
+// esis[i]는 i번째 기호의 ESI입니다. 디코딩을 시도할 만큼 방정식이 모이면 1을 반환합니다.
+// 원본 기호(ESI < K)는 들어간 행을 기록해 두었다가 디코딩 때 그대로 복사합니다.
+int add_blocks(void* decoder, const uint16_t* esis, const uint8_t* blocks, int num_blocks) {
+    raptor_decoder* d = (raptor_decoder*)decoder;
+    int indices[MAX_SOURCE_SYMBOLS];
+    int num_indices;
+    STATS_TIMER(t0);
+    for (int i = 0; i < num_blocks; i++) {
+        if (esis[i] < d->params.K && d->source_rows[esis[i]] < 0) {
+            d->source_rows[esis[i]] = d->matrix->num_rows;
+            d->num_source++;
+        }
+        pick_indices(&d->params, esis[i], indices, &num_indices);
+        inactivation_add_row(d->matrix, indices, num_indices, blocks + (size_t)i * d->symbol_size);
+    }
+    if (d->num_source == d->params.K) {
+        // 원본 기호가 모두 왔으면 풀이 없이 복사만 합니다.
+        STATS_DETERMINED(&d->matrix->stats);
+    }
+    STATS_ELAPSED(&d->matrix->stats, addNanos, t0);
+    return d->num_source == d->params.K || d->matrix->num_rows >= d->params.L;
 }
 
-// 블록 추가
-int add_blocks(void* decoder, const uint8_t* blocks, int num_blocks) {
-    // 블록 추가 로직
-    return 0;
+// 호출자 버퍼로 디코딩. out은 symbolBufferSize(message_length, K) 바이트 이상이어야
+// 하고, 성공하면 out의 앞쪽 message_length 바이트가 메시지입니다. 받은 원본 기호는
+// 그대로 복사하고, 잃어버린 것만 중간 기호를 푼 뒤 out 위에 바로 LT 인코딩합니다.
+// 원본 기호가 모두 왔으면 풀이 없이 복사만 합니다.
+bool decode_into(void* decoder, uint8_t* out) {
+    raptor_decoder* d = (raptor_decoder*)decoder;
+    const raptor_params* p = &d->params;
+    symbolMatrix* intermediate = NULL;
+    if (d->num_source < p->K) {
+        intermediate = newSymbolMatrix(p->L, d->symbol_size, d->codec.SymbolAlignmentSize);
+        if (!inactivation_solve(d->matrix, intermediate)) {
+            freeSymbolMatrix(intermediate);
+            return false;
+        }
+    }
+
+    symbolMatrix* source = viewSymbols(out, p->K, d->symbol_size);
+    for (int i = 0; i < p->K; i++) {
+        if (d->source_rows[i] >= 0) {
+            memcpy(symbolAt(source, i), d->matrix->row_values[d->source_rows[i]], d->symbol_size);
+        } else {
+            lt_encode(p, (uint16_t)i, intermediate, symbolAt(source, i));
+        }
+    }
+    compactSymbols(source, p->K, d->message_length);
+    freeSymbolMatrix(source);
+    freeSymbolMatrix(intermediate);
+    return true;
 }
 
-// 디코딩
+// 디코딩. 원본 기호는 ESI 0..K-1의 인코딩 기호입니다.
 uint8_t* decode(void* decoder, int* out_length) {
-    // 디코딩 로직
-    return NULL;
-}
\ No newline at end of file
+    raptor_decoder* d = (raptor_decoder*)decoder;
+    uint8_t* out = (uint8_t*)malloc(symbolBufferSize(d->message_length, d->params.K));
+    if (!decode_into(d, out)) {
+        free(out);
+        return NULL;
+    }
+
+    *out_length = d->message_length;
+    return out;
+}
@@ -0,0 +1,434 @@
+#include "raptorq.h"
+#include "gf256.h"
+#include "prng.h"
+#include "xor.h"
+#include "inactivation.h"
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <pthread.h>
+
+// 인코딩 기호 하나가 고르는 중간 기호의 최대 수 (LT 30개 + PI 3개)
+#define MAX_TUPLE_INDICES 33
+
+// K마다 한 번 계산하는 값 (체계적 인덱스와 HDPC 계수). 프로세스가 끝날 때까지
+// 유지되므로 raptorq_params를 값으로 복사해도 안전합니다.
+typedef struct {
+    uint32_t J;
+    uint8_t* hdpc;
+} systematic_entry;
+
+static systematic_entry* systematic_cache[RAPTORQ_MAX_SOURCE_SYMBOLS + 1];
+static pthread_mutex_t systematic_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void systematic_params(raptorq_params* p);
+
+// RaptorQCodec 생성 함수. source_blocks는 1..RAPTORQ_MAX_SOURCE_SYMBOLS입니다.
+RaptorQCodec* create_raptorq_codec(int source_blocks, int alignment_size) {
+    RaptorQCodec* codec = (RaptorQCodec*)malloc(sizeof(RaptorQCodec));
+    if (codec) {
+        codec->NumSourceSymbols = source_blocks;
+        codec->SymbolAlignmentSize = alignment_size;
+        raptorq_params_init(&codec->params, source_blocks);
+    }
+    return codec;
+}
+
+// RaptorQCodec 해제 함수
+void destroy_raptorq_codec(RaptorQCodec* codec) {
+    if (codec) {
+        free(codec);
+    }
+}
+
+static bool is_prime(int n) {
+    if (n < 2) {
+        return false;
+    }
+    for (int d = 2; d * d <= n; d++) {
+        if (n % d == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// n 이상의 가장 작은 소수
+static int next_prime(int n) {
+    while (!is_prime(n)) {
+        n++;
+    }
+    return n;
+}
+
+// n 이하의 가장 큰 소수 (n >= 2)
+static int prev_prime(int n) {
+    while (!is_prime(n)) {
+        n--;
+    }
+    return n;
+}
+
+// 랜덤 함수. RFC 6330 5.3.5.1의 Rand(y, i, m)과 같은 역할이지만 V0..V3 표 대신
+// (i, y)를 SplitMix64로 섞습니다.
+uint32_t raptorq_rand(uint32_t y, uint32_t i, uint32_t m) {
+    return (uint32_t)(splitmix64(((uint64_t)i << 32) | y) % m);
+}
+
+// 디그리 함수 (RFC 6330 5.3.5.2). 차수는 W - 2를 넘지 않습니다.
+int raptorq_deg(uint32_t v, int w) {
+    static const uint32_t f[] = {
+        0, 5243, 529531, 704294, 791675, 844104, 879057, 904023, 922747, 937311, 948962,
+        958494, 966438, 973160, 978921, 983914, 988283, 992138, 995565, 998631, 1001391,
+        1003887, 1006157, 1008229, 1010129, 1011876, 1013490, 1014983, 1016370, 1017662, 1048576
+    };
+    int d = 1;
+    while (d < (int)(sizeof(f) / sizeof(f[0])) - 1 && v >= f[d]) {
+        d++;
+    }
+    return d < w - 2 ? d : w - 2;
+}
+
+// K에만 의존하는 값들을 한 번에 계산합니다. S는 RFC 5053과 같은 식으로 정하고,
+// H는 RFC 6330의 표처럼 10에서 시작해 K가 커지면 log2(K)만큼 늘립니다.
+// W는 K+S - ceil(sqrt(K)/2) 이하의 가장 큰 소수라 PI 기호가 HDPC 기호 H개보다
+// sqrt(K)/2개쯤 많습니다. K가 수천 이상일 때 PI 기호가 H개 근처이면 K+2개를 받고도
+// 실패하는 경우가 몇 %씩 생기지만, 이만큼 두면 밀집 시스템이 조금 커지는 대신 사라집니다.
+void raptorq_params_init(raptorq_params* p, int k) {
+    int x = 2;
+    while (x * (x - 1) < 2 * k) {
+        x++;
+    }
+    p->K = k;
+    p->S = next_prime((int)ceil(0.01 * (double)k) + x);
+    p->H = 10;
+    while ((1 << p->H) < k) {
+        p->H++;
+    }
+    p->L = k + p->S + p->H;
+    p->W = prev_prime(k + p->S - (int)ceil(sqrt((double)k) / 2));
+    p->B = p->W - p->S;
+    p->P = p->L - p->W;
+    p->P1 = next_prime(p->P);
+    systematic_params(p);
+}
+
+// 튜플 생성기 (RFC 6330 5.3.5.4)
+void raptorq_tuple(const raptorq_params* p, uint32_t x, rq_tuple* t) {
+    uint32_t a = 53591 + p->J * 997;
+    if (a % 2 == 0) {
+        a++;
+    }
+    uint32_t b = 10267 * (p->J + 1);
+    uint32_t y = b + x * a;
+    uint32_t v = raptorq_rand(y, 0, 1048576);
+    t->d = raptorq_deg(v, p->W);
+    t->a = 1 + (int)raptorq_rand(y, 1, p->W - 1);
+    t->b = (int)raptorq_rand(y, 2, p->W);
+    t->d1 = t->d < 4 ? 2 + (int)raptorq_rand(x, 3, 2) : 2;
+    t->a1 = 1 + (int)raptorq_rand(x, 4, p->P1 - 1);
+    t->b1 = (int)raptorq_rand(x, 5, p->P1);
+}
+
+// 인코딩 기호 x가 XOR하는 중간 기호 (RFC 6330 5.3.5.3). W가 소수이고 d <= W - 2라
+// LT 기호는 겹치지 않고, PI 기호도 P1 주기 안에서 d1 <= 3개만 고르므로 겹치지 않습니다.
+void raptorq_indices(const raptorq_params* p, uint32_t x, int* indices, int* num_indices) {
+    rq_tuple t;
+    raptorq_tuple(p, x, &t);
+    int n = 0;
+    int b = t.b;
+    indices[n++] = b;
+    for (int j = 1; j < t.d; j++) {
+        b = (b + t.a) % p->W;
+        indices[n++] = b;
+    }
+    int b1 = t.b1;
+    while (b1 >= p->P) {
+        b1 = (b1 + t.a1) % p->P1;
+    }
+    indices[n++] = p->W + b1;
+    for (int j = 1; j < t.d1; j++) {
+        b1 = (b1 + t.a1) % p->P1;
+        while (b1 >= p->P) {
+            b1 = (b1 + t.a1) % p->P1;
+        }
+        indices[n++] = p->W + b1;
+    }
+    *num_indices = n;
+}
+
+// HDPC 계수 (RFC 6330 5.3.3.3). MT는 열마다 1이 두 개인 H x (K+S) 행렬이고
+// 마지막 열만 alpha^i입니다. GAMMA[i][j] = alpha^(i-j) (i >= j)이므로 MT x GAMMA의
+// 각 행은 R[j] = MT[j] + alpha * R[j+1]로 뒤에서부터 한 번에 구합니다.
+static uint8_t* hdpc_coefficients(const raptorq_params* p) {
+    int n = p->K + p->S;
+    int h = p->H;
+    uint8_t* mt = (uint8_t*)calloc((size_t)h * n, 1);
+    for (int j = 0; j < n - 1; j++) {
+        int r1 = (int)raptorq_rand(j + 1, 6, h);
+        int r2 = (r1 + (int)raptorq_rand(j + 1, 7, h - 1) + 1) % h;
+        mt[(size_t)r1 * n + j] = 1;
+        mt[(size_t)r2 * n + j] = 1;
+    }
+    for (int i = 0; i < h; i++) {
+        uint8_t* row = mt + (size_t)i * n;
+        row[n - 1] = gf256Exp(i);
+        for (int j = n - 2; j >= 0; j--) {
+            row[j] ^= gf256Mul(2, row[j + 1]);
+        }
+    }
+    return mt;
+}
+
+// LDPC 제약 방정식 S개와 HDPC 제약 방정식 H개를 추가하고 (RFC 6330 5.3.3.3),
+// 마지막 P개의 열(PI 기호)을 처음부터 비활성으로 둡니다.
+void raptorq_add_constraints(inactivation_decoder* dec, const raptorq_params* p) {
+    int s = p->S;
+    int** rows = (int**)malloc(s * sizeof(int*));
+    int* lens = (int*)calloc(s, sizeof(int));
+    // 행마다 들어갈 열 수를 먼저 세어 정확히 잡습니다 (PI 열 2개와 B + i 하나 포함).
+    for (int i = 0; i < p->B; i++) {
+        int a = 1 + (i / s) % (s - 1);
+        int b = i % s;
+        for (int j = 0; j < 3; j++) {
+            lens[b]++;
+            b = (b + a) % s;
+        }
+    }
+    for (int i = 0; i < s; i++) {
+        rows[i] = (int*)malloc((lens[i] + 3) * sizeof(int));
+        lens[i] = 0;
+    }
+
+    for (int i = 0; i < p->B; i++) {
+        int a = 1 + (i / s) % (s - 1);
+        int b = i % s;
+        for (int j = 0; j < 3; j++) {
+            rows[b][lens[b]++] = i;
+            b = (b + a) % s;
+        }
+    }
+    for (int i = 0; i < s; i++) {
+        rows[i][lens[i]++] = p->B + i;
+        rows[i][lens[i]++] = p->W + i % p->P;
+        rows[i][lens[i]++] = p->W + (i + 1) % p->P;
+    }
+    for (int i = 0; i < s; i++) {
+        inactivation_add_row(dec, rows[i], lens[i], NULL);
+        free(rows[i]);
+    }
+    free(rows);
+    free(lens);
+
+    int n = p->K + p->S;
+    uint8_t* coeffs = (uint8_t*)malloc(p->L);
+    for (int i = 0; i < p->H; i++) {
+        memcpy(coeffs, p->hdpc + (size_t)i * n, n);
+        memset(coeffs + n, 0, p->H);
+        coeffs[n + i] = 1;
+        inactivation_add_dense_row(dec, coeffs, NULL);
+    }
+    free(coeffs);
+    dec->num_permanent = p->P;
+}
+
+// 인코딩: c의 중간 기호 중 x에 해당하는 것들을 XOR해 result에 씁니다.
+void raptorq_encode(const raptorq_params* p, uint32_t x, const symbolMatrix* c, uint8_t* result) {
+    int indices[MAX_TUPLE_INDICES];
+    const uint8_t* srcs[MAX_TUPLE_INDICES];
+    int num_indices;
+    raptorq_indices(p, x, indices, &num_indices);
+    for (int i = 0; i < num_indices; i++) {
+        srcs[i] = symbolAt(c, indices[i]);
+    }
+    xorBytesGather(result, srcs, num_indices, c->symbolSize);
+}
+
+// 체계적 인덱스 찾기. ESI 0..K-1의 행과 제약 방정식으로 이루어진 L x L 시스템이
+// 가역인 가장 작은 J를 고릅니다. RFC 6330의 표도 같은 방식으로 만들어졌고, HDPC 행
+// 덕분에 대부분의 K에서 J = 0이 가역입니다. 값은 쓰지 않으므로 기호 크기 0으로 풉니다.
+static uint32_t find_systematic_index(raptorq_params* p) {
+    int indices[MAX_TUPLE_INDICES];
+    int num_indices;
+    symbolMatrix* scratch = newSymbolMatrix(p->L, 0, 1);
+    for (p->J = 0;; p->J++) {
+        inactivation_decoder* matrix = new_inactivation_decoder(p->L, 0);
+        raptorq_add_constraints(matrix, p);
+        for (int i = 0; i < p->K; i++) {
+            raptorq_indices(p, i, indices, &num_indices);
+            inactivation_add_row(matrix, indices, num_indices, NULL);
+        }
+        bool ok = inactivation_solve(matrix, scratch);
+        destroy_inactivation_decoder(matrix);
+        if (ok) {
+            break;
+        }
+    }
+    freeSymbolMatrix(scratch);
+    return p->J;
+}
+
+static void systematic_params(raptorq_params* p) {
+    if (p->K < 1 || p->K > RAPTORQ_MAX_SOURCE_SYMBOLS) {
+        p->J = 0;
+        p->hdpc = NULL;
+        return;
+    }
+    pthread_mutex_lock(&systematic_lock);
+    systematic_entry* e = systematic_cache[p->K];
+    pthread_mutex_unlock(&systematic_lock);
+
+    // 풀이 여러 번이 걸릴 수 있으므로 잠금 밖에서 계산하고 결과만 잠금 안에서 올립니다.
+    // 같은 K를 동시에 계산한 스레드가 있으면 먼저 올린 쪽을 쓰고 자기 것은 버립니다.
+    if (e == NULL) {
+        systematic_entry* fresh = (systematic_entry*)malloc(sizeof(systematic_entry));
+        fresh->hdpc = hdpc_coefficients(p);
+        p->hdpc = fresh->hdpc;
+        fresh->J = find_systematic_index(p);
+
+        pthread_mutex_lock(&systematic_lock);
+        e = systematic_cache[p->K];
+        if (e == NULL) {
+            e = fresh;
+            systematic_cache[p->K] = e;
+        }
+        pthread_mutex_unlock(&systematic_lock);
+        if (e != fresh) {
+            free(fresh->hdpc);
+            free(fresh);
+        }
+    }
+    p->J = e->J;
+    p->hdpc = e->hdpc;
+}
+
+// 중간 블록 생성 (RFC 6330 5.3.3.4). 제약 방정식에 "ESI i의 행 = 원본 기호 i" (i < K)를
+// 더한 시스템을 디코더와 같은 풀이기로 풀어, ESI 0..K-1의 인코딩 기호가 원본 기호와
+// 같도록 중간 기호 L개를 정합니다. p는 source->count에 대한 값이어야 하고, 풀리지
+// 않으면 false를 반환합니다.
+bool raptorq_intermediate_blocks(const raptorq_params* p, const symbolMatrix* source, symbolMatrix* intermediate_blocks) {
+    int indices[MAX_TUPLE_INDICES];
+    int num_indices;
+
+    inactivation_decoder* matrix = new_inactivation_decoder(p->L, source->symbolSize);
+    raptorq_add_constraints(matrix, p);
+    for (int i = 0; i < p->K; i++) {
+        raptorq_indices(p, i, indices, &num_indices);
+        inactivation_add_row(matrix, indices, num_indices, symbolAt(source, i));
+    }
+    bool ok = inactivation_solve(matrix, intermediate_blocks);
+    destroy_inactivation_decoder(matrix);
+    return ok;
+}
+
+// 메시지를 p->K개의 원본 기호로 나눠 중간 블록 생성. 원본 기호는 정렬된 연속 메모리
+// 하나에 나눠 담습니다. 풀리지 않으면 NULL을 반환합니다.
+symbolMatrix* raptorq_generate_intermediate_blocks(const raptorq_params* p, const uint8_t* message, int message_length, int alignment) {
+    symbolMatrix* source = partitionSymbols(message, message_length, p->K, alignment);
+    symbolMatrix* intermediate = newSymbolMatrix(p->L, source->symbolSize, alignment);
+    if (!raptorq_intermediate_blocks(p, source, intermediate)) {
+        freeSymbolMatrix(intermediate);
+        intermediate = NULL;
+    }
+    freeSymbolMatrix(source);
+    return intermediate;
+}
+
+// 디코더 생성. LDPC와 HDPC 제약 방정식을 미리 넣어 둡니다.
+void* raptorq_new_decoder(const RaptorQCodec* codec, int message_length) {
+    raptorq_decoder* decoder = (raptorq_decoder*)malloc(sizeof(raptorq_decoder));
+    decoder->codec = *codec;
+    decoder->message_length = message_length;
+    int K = codec->NumSourceSymbols;
+    decoder->symbol_size = (message_length + K - 1) / K;
+    if (codec->params.K == K) {
+        decoder->params = codec->params;
+    } else {
+        raptorq_params_init(&decoder->params, K);
+    }
+    raptorq_params* p = &decoder->params;
+    decoder->matrix = new_inactivation_decoder(p->L, decoder->symbol_size);
+    raptorq_add_constraints(decoder->matrix, p);
+    decoder->source_rows = (int*)malloc(K * sizeof(int));
+    for (int i = 0; i < K; i++) {
+        decoder->source_rows[i] = -1;
+    }
+    decoder->num_source = 0;
+    return decoder;
+}
+
+// 디코더 해제
+void raptorq_destroy_decoder(void* decoder) {
+    raptorq_decoder* d = (raptorq_decoder*)decoder;
+    if (d) {
+        destroy_inactivation_decoder(d->matrix);
+        free(d->source_rows);
+        free(d);
+    }
+}
+
+// 블록 추가. blocks에는 symbol_size 간격으로 num_blocks개의 기호가 있고
+// esis[i]는 i번째 기호의 ESI입니다. 받은 기호가 K개 이상이면 (제약 방정식과 합쳐
+// 방정식이 L개 이상이면) 디코딩을 시도할 만하므로 1을 반환합니다.
+int raptorq_add_blocks(void* decoder, const uint32_t* esis, const uint8_t* blocks, int num_blocks) {
+    raptorq_decoder* d = (raptorq_decoder*)decoder;
+    int indices[MAX_TUPLE_INDICES];
+    int num_indices;
+    STATS_TIMER(t0);
+    for (int i = 0; i < num_blocks; i++) {
+        if (esis[i] < (uint32_t)d->params.K && d->source_rows[esis[i]] < 0) {
+            d->source_rows[esis[i]] = d->matrix->num_rows;
+            d->num_source++;
+        }
+        raptorq_indices(&d->params, esis[i], indices, &num_indices);
+        inactivation_add_row(d->matrix, indices, num_indices, blocks + (size_t)i * d->symbol_size);
+    }
+    if (d->num_source == d->params.K) {
+        // 원본 기호가 모두 왔으면 풀이 없이 복사만 합니다.
+        STATS_DETERMINED(&d->matrix->stats);
+    }
+    STATS_ELAPSED(&d->matrix->stats, addNanos, t0);
+    return d->num_source == d->params.K || d->matrix->num_rows + d->matrix->num_dense >= d->params.L;
+}
+
+// 호출자 버퍼로 디코딩. out은 symbolBufferSize(message_length, K) 바이트 이상이어야
+// 하고, 성공하면 out의 앞쪽 message_length 바이트가 메시지입니다. 받은 원본 기호는
+// 그대로 복사하고, 잃어버린 것만 중간 기호를 푼 뒤 out 위에 바로 인코딩합니다.
+bool raptorq_decode_into(void* decoder, uint8_t* out) {
+    raptorq_decoder* d = (raptorq_decoder*)decoder;
+    const raptorq_params* p = &d->params;
+    symbolMatrix* intermediate = NULL;
+    if (d->num_source < p->K) {
+        intermediate = newSymbolMatrix(p->L, d->symbol_size, d->codec.SymbolAlignmentSize);
+        if (!inactivation_solve(d->matrix, intermediate)) {
+            freeSymbolMatrix(intermediate);
+            return false;
+        }
+    }
+
+    symbolMatrix* source = viewSymbols(out, p->K, d->symbol_size);
+    for (int i = 0; i < p->K; i++) {
+        if (d->source_rows[i] >= 0) {
+            memcpy(symbolAt(source, i), d->matrix->row_values[d->source_rows[i]], d->symbol_size);
+        } else {
+            raptorq_encode(p, i, intermediate, symbolAt(source, i));
+        }
+    }
+    compactSymbols(source, p->K, d->message_length);
+    freeSymbolMatrix(source);
+    freeSymbolMatrix(intermediate);
+    return true;
+}
+
+// 디코딩. 원본 기호는 ESI 0..K-1의 인코딩 기호입니다.
+uint8_t* raptorq_decode(void* decoder, int* out_length) {
+    raptorq_decoder* d = (raptorq_decoder*)decoder;
+    uint8_t* out = (uint8_t*)malloc(symbolBufferSize(d->message_length, d->params.K));
+    if (!raptorq_decode_into(d, out)) {
+        free(out);
+        return NULL;
+    }
+
+    *out_length = d->message_length;
+    return out;
+}
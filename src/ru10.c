@@ -1,4 +1,7 @@
 #include "ru10.h"
+#include "inactivation.h"
+#include "xor.h"
+#include "mersenne.h"
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
@@ -7,13 +10,9 @@
 
 // Helper functions to be implemented
 static int smallest_prime_greater_or_equal(int n);
-static int* intermediate_symbols(int k);
+static void intermediate_symbols(int k, int* l, int* s, int* h);
 static int deg(uint32_t v);
-static void generate_luby_transform_block(const uint8_t* source, const int* composition, int compositionSize, uint8_t* result);
-static uint64_t build_gray_sequence(int k, int hprime);
-static int bit_set(uint64_t num, uint64_t bit);
-static void partition_bytes(const uint8_t* message, int numSourceSymbols, uint8_t** sourceLong, uint8_t** sourceShort, int* longSize, int* shortSize);
-static void equalize_block_lengths(uint8_t** sourceLong, uint8_t** sourceShort, int longSize, int shortSize);
+static void build_gray_sequence(int length, int b, uint32_t* sequence);
 
 // Example implementations of helper functions
 static int smallest_prime_greater_or_equal(int n) {
@@ -33,47 +32,83 @@ static int smallest_prime_greater_or_equal(int n) {
     }
 }
 
-static int* intermediate_symbols(int k) {
-    // Example stub for intermediate symbols calculation
-    static int symbols[3] = {0}; // Placeholder
-    return symbols;
-}
-
-static int deg(uint32_t v) {
-    // Example stub for degree calculation
-    return (int)(v % 10); // Placeholder
-}
-
-static void generate_luby_transform_block(const uint8_t* source, const int* composition, int compositionSize, uint8_t* result) {
-    // Example stub for generating Luby Transform block
-    memset(result, 0, compositionSize); // Placeholder
+static int center_binomial(int n) {
+    int64_t f = 1;
+    for (int i = 1; i <= n / 2; i++) {
+        f = f * (n - n / 2 + i) / i;
+    }
+    return (int)f;
 }
 
-static uint64_t build_gray_sequence(int k, int hprime) {
-    // Example stub for building a Gray sequence
-    return 0; // Placeholder
-}
+// Computes L, S and H for k source symbols (RFC 5053 section 5.4.2.3)
+static void intermediate_symbols(int k, int* l, int* s, int* h) {
+    int x = (int)floor(sqrt(2 * (double)k));
+    if (x < 1) {
+        x = 1;
+    }
+    while (x * (x - 1) < 2 * k) {
+        x++;
+    }
 
-static int bit_set(uint64_t num, uint64_t bit) {
-    return (num & (1ULL << bit)) ? 1 : 0;
+    *s = smallest_prime_greater_or_equal((int)ceil(0.01 * (double)k) + x);
+    *h = (int)floor(log((double)(*s + k)) / log(4));
+    while (center_binomial(*h) < k + *s) {
+        (*h)++;
+    }
+    *l = k + *s + *h;
 }
 
-static void partition_bytes(const uint8_t* message, int numSourceSymbols, uint8_t** sourceLong, uint8_t** sourceShort, int* longSize, int* shortSize) {
-    // Example stub for partitioning bytes
-    *sourceLong = NULL;
-    *sourceShort = NULL;
-    *longSize = 0;
-    *shortSize = 0;
+// Degree distribution from RFC 5053 section 5.4.4.2
+static int deg(uint32_t v) {
+    static const uint32_t f[] = {0, 10241, 491582, 712794, 831695, 948446, 1032189, 1048576};
+    static const int d[] = {0, 1, 2, 3, 4, 10, 11, 40};
+    for (int j = 1; j < (int)(sizeof(f) / sizeof(f[0])) - 1; j++) {
+        if (v < f[j]) {
+            return d[j];
+        }
+    }
+    return d[sizeof(d) / sizeof(d[0]) - 1];
 }
 
-static void equalize_block_lengths(uint8_t** sourceLong, uint8_t** sourceShort, int longSize, int shortSize) {
-    // Example stub for equalizing block lengths
+// Fills sequence with the first length Gray codes of weight b
+static void build_gray_sequence(int length, int b, uint32_t* sequence) {
+    int i = 0;
+    for (uint32_t x = 0; i < length; x++) {
+        uint32_t g = x ^ (x >> 1);
+        if (__builtin_popcount(g) == b) {
+            sequence[i++] = g;
+        }
+    }
 }
 
 ru10_codec* create_ru10_codec(int numSourceSymbols, int symbolAlignmentSize) {
     ru10_codec* codec = (ru10_codec*)malloc(sizeof(ru10_codec));
     codec->numSourceSymbols = numSourceSymbols;
     codec->symbolAlignmentSize = symbolAlignmentSize;
+    intermediate_symbols(numSourceSymbols, &codec->l, &codec->s, &codec->h);
+    codec->lprime = smallest_prime_greater_or_equal(codec->l);
+    codec->prng = PRNG_LIBC;
+    codec->seed = 0;
+    return codec;
+}
+
+// Creates a codec whose pick_indices uses the counter-based generator keyed by
+// (seed, block ID). It touches no global state, so encoders can call it from
+// many threads.
+ru10_codec* create_ru10_codec_seeded(int numSourceSymbols, int symbolAlignmentSize, uint64_t seed) {
+    ru10_codec* codec = create_ru10_codec(numSourceSymbols, symbolAlignmentSize);
+    codec->prng = PRNG_COUNTER;
+    codec->seed = seed;
+    return codec;
+}
+
+// Creates a codec whose pick_indices seeds MT19937 with seed ^ block ID and
+// takes its first three outputs. Like the seeded codec it keeps no shared
+// state, so it is safe to call from many threads.
+ru10_codec* create_ru10_codec_mt19937(int numSourceSymbols, int symbolAlignmentSize, uint64_t seed) {
+    ru10_codec* codec = create_ru10_codec(numSourceSymbols, symbolAlignmentSize);
+    codec->prng = PRNG_MT19937;
+    codec->seed = seed;
     return codec;
 }
 
@@ -89,14 +124,30 @@ int get_source_blocks(const ru10_codec* codec) {
 
 int pick_indices(const ru10_codec* codec, int64_t codeBlockIndex, int* indices, int maxIndices) {
     int d, a, b;
-    int l = intermediate_symbols(codec->numSourceSymbols)[0];
-    int lprime = smallest_prime_greater_or_equal(l);
-
-    // Random number generation using a Mersenne Twister (Placeholder implementation)
-    srand((unsigned int)codeBlockIndex);
-    uint32_t v = (uint32_t)(rand() % 1048576);
-    a = 1 + (rand() % (lprime - 1));
-    b = (int)(rand() % lprime);
+    int l = codec->l;
+    int lprime = codec->lprime;
+    uint32_t v;
+
+    if (codec->prng == PRNG_COUNTER) {
+        counterRng rng;
+        counterRngInit(&rng, codec->seed, codeBlockIndex);
+        uint64_t x = counterRngNext(&rng);
+        v = (uint32_t)(x & 0xFFFFF);
+        a = 1 + (int)((x >> 20) % (uint64_t)(lprime - 1));
+        b = (int)(counterRngNext(&rng) % (uint64_t)lprime);
+    } else if (codec->prng == PRNG_MT19937) {
+        // Only three outputs are needed, so skip building the full MT state
+        uint32_t r[3];
+        drawMT((int64_t)(codec->seed ^ (uint64_t)codeBlockIndex), r, 3);
+        v = r[0] % 1048576;
+        a = 1 + (int)(r[1] % (uint32_t)(lprime - 1));
+        b = (int)(r[2] % (uint32_t)lprime);
+    } else {
+        srand((unsigned int)codeBlockIndex);
+        v = (uint32_t)(rand() % 1048576);
+        a = 1 + (rand() % (lprime - 1));
+        b = (int)(rand() % lprime);
+    }
     d = deg(v);
 
     if (d > l) {
@@ -131,39 +182,116 @@ int pick_indices(const ru10_codec* codec, int64_t codeBlockIndex, int* indices,
     return count;
 }
 
-void generate_intermediate_blocks(const ru10_codec* codec, const uint8_t* message, size_t message_len, uint8_t** blocks, int* numBlocks) {
+// Builds the L = K+S+H intermediate symbols in one contiguous matrix. The first k
+// rows are the source symbols, followed by the S LDPC and H Half symbols that
+// satisfy the constraint rows the decoder adds (RFC 5053 section 5.4.2.3).
+symbolMatrix* generate_intermediate_blocks(const ru10_codec* codec, const uint8_t* message, size_t message_len) {
     int k = codec->numSourceSymbols;
-    uint8_t *sourceLong, *sourceShort;
-    int longSize, shortSize;
-    partition_bytes(message, k, &sourceLong, &sourceShort, &longSize, &shortSize);
-    equalize_block_lengths(&sourceLong, &sourceShort, longSize, shortSize);
+    int l = codec->l, s = codec->s, h = codec->h;
 
-    int s, h;
-    int* compositions = intermediate_symbols(k);
-    s = compositions[1];
-    h = compositions[2];
+    symbolMatrix* source = partitionSymbols(message, (int)message_len, k, codec->symbolAlignmentSize);
+    symbolMatrix* blocks = newSymbolMatrix(l, source->symbolSize, codec->symbolAlignmentSize);
+    memcpy(blocks->data, source->data, (size_t)k * source->stride);
+    freeSymbolMatrix(source);
 
-    *numBlocks = k + s + h;
-    *blocks = (uint8_t*)malloc(*numBlocks * sizeof(uint8_t)); // Placeholder for blocks
-
-    // Generate S and H blocks
-    for (int i = 0; i < s; i++) {
-        int* composition = (int*)malloc(sizeof(int) * k); // Placeholder
-        generate_luby_transform_block(sourceLong, composition, k, *blocks + i * sizeof(uint8_t)); // Placeholder
-        free(composition);
+    // Each source symbol contributes to three LDPC symbols
+    for (int i = 0; i < k; i++) {
+        int a = 1 + (i / s) % (s - 1);
+        int b = i % s;
+        for (int j = 0; j < 3; j++) {
+            xorBytes(symbolAt(blocks, k + b), symbolAt(blocks, i), blocks->symbolSize);
+            b = (b + a) % s;
+        }
     }
 
-    // Generate H blocks
+    // Half symbols cover the source and LDPC symbols selected by the Gray sequence
     int hprime = (int)ceil((double)h / 2);
-    uint64_t graySeq = build_gray_sequence(k + s, hprime);
+    uint32_t* m = (uint32_t*)malloc((k + s) * sizeof(uint32_t));
+    const uint8_t** srcs = (const uint8_t**)malloc((k + s) * sizeof(uint8_t*));
+    build_gray_sequence(k + s, hprime, m);
     for (int i = 0; i < h; i++) {
-        int* hcomposition = (int*)malloc(sizeof(int) * (k + s)); // Placeholder
+        int n = 0;
         for (int j = 0; j < k + s; j++) {
-            if (bit_set(graySeq, i)) {
-                hcomposition[j] = j;
+            if ((m[j] >> i) & 1) {
+                srcs[n++] = symbolAt(blocks, j);
             }
         }
-        generate_luby_transform_block(sourceLong, hcomposition, k + s, *blocks + (s + i) * sizeof(uint8_t)); // Placeholder
-        free(hcomposition);
+        xorBytesGather(symbolAt(blocks, k + s + i), srcs, n, blocks->symbolSize);
+    }
+    free(srcs);
+    free(m);
+    return blocks;
+}
+
+ru10_decoder* new_ru10_decoder(const ru10_codec* codec, int message_length) {
+    ru10_decoder* decoder = (ru10_decoder*)malloc(sizeof(ru10_decoder));
+    decoder->codec = *codec;
+    decoder->message_length = message_length;
+    decoder->k = codec->numSourceSymbols;
+    decoder->symbol_size = (message_length + decoder->k - 1) / decoder->k;
+
+    decoder->l = codec->l;
+    decoder->s = codec->s;
+    decoder->h = codec->h;
+
+    // The LDPC and half symbols are constraints with a zero right-hand side
+    decoder->matrix = new_inactivation_decoder(decoder->l, decoder->symbol_size);
+    inactivation_add_constraints(decoder->matrix, decoder->k, decoder->s, decoder->h);
+    return decoder;
+}
+
+void destroy_ru10_decoder(ru10_decoder* decoder) {
+    if (decoder != NULL) {
+        destroy_inactivation_decoder(decoder->matrix);
+        free(decoder);
+    }
+}
+
+// Adds numBlocks encoded symbols, stored back to back in blocks, with the
+// given code block IDs. Returns 1 once there are enough equations to try decoding.
+int ru10_add_blocks(ru10_decoder* decoder, const int64_t* ids, const uint8_t* blocks, int numBlocks) {
+    STATS_TIMER(t0);
+    int* indices = (int*)malloc(decoder->l * sizeof(int));
+    for (int i = 0; i < numBlocks; i++) {
+        int count = pick_indices(&decoder->codec, ids[i], indices, decoder->l);
+        inactivation_add_row(decoder->matrix, indices, count, blocks + (size_t)i * decoder->symbol_size);
     }
-}
\ No newline at end of file
+    free(indices);
+    STATS_ELAPSED(&decoder->matrix->stats, addNanos, t0);
+    return decoder->matrix->num_rows >= decoder->l;
+}
+
+// Decodes into a caller buffer of at least symbolBufferSize(message_length, k)
+// bytes. RU10 is not systematic: the first k intermediate symbols are the
+// source symbols, copied out once and compacted in place.
+bool ru10_decode_into(ru10_decoder* decoder, uint8_t* out) {
+    symbolMatrix* intermediate = newSymbolMatrix(decoder->l, decoder->symbol_size, decoder->codec.symbolAlignmentSize);
+    if (!inactivation_solve(decoder->matrix, intermediate)) {
+        freeSymbolMatrix(intermediate);
+        return false;
+    }
+
+    symbolMatrix* source = viewSymbols(out, decoder->k, decoder->symbol_size);
+    if (intermediate->stride == source->stride) {
+        memcpy(source->data, intermediate->data, (size_t)decoder->k * source->stride);
+    } else {
+        for (int i = 0; i < decoder->k; i++) {
+            memcpy(symbolAt(source, i), symbolAt(intermediate, i), decoder->symbol_size);
+        }
+    }
+    compactSymbols(source, decoder->k, decoder->message_length);
+    freeSymbolMatrix(source);
+    freeSymbolMatrix(intermediate);
+    return true;
+}
+
+uint8_t* ru10_decode(ru10_decoder* decoder, int* out_length) {
+    uint8_t* out = (uint8_t*)malloc(symbolBufferSize(decoder->message_length, decoder->k));
+    if (!ru10_decode_into(decoder, out)) {
+        free(out);
+        return NULL;
+    }
+
+    *out_length = decoder->message_length;
+    return out;
+}
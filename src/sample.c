@@ -0,0 +1,78 @@
+#include <stdlib.h>
+#include <string.h>
+#include "sample.h"
+
+// Slots in the on-stack membership table; larger samples allocate theirs
+#define SAMPLE_TABLE_SLOTS 4096
+
+static int compareInts(const void* a, const void* b) {
+    return (*(const int*)a > *(const int*)b) - (*(const int*)a < *(const int*)b);
+}
+
+// Adds x to the open-addressed set table (slots is a power of two, empty slots
+// hold -1) unless it is already there. Returns false if it was.
+static bool tableInsert(int* table, int slots, int x) {
+    unsigned int h = ((unsigned int)x * 2654435761u) & (slots - 1);
+    while (table[h] >= 0) {
+        if (table[h] == x) {
+            return false;
+        }
+        h = (h + 1) & (slots - 1);
+    }
+    table[h] = x;
+    return true;
+}
+
+// Writes d distinct indices drawn uniformly from [0, max) into out, which must
+// hold min(d, max) ints, and returns how many were written. Uses Floyd's
+// algorithm: step j draws t from [0, j] and takes j instead if t is already
+// taken, so every subset is equally likely with exactly d draws. Small samples
+// check membership by scanning out; larger ones use a hash set at most half
+// full, kept on the stack up to SAMPLE_TABLE_SLOTS. Either way a draw is O(1)
+// expected, and sorted output costs one sort at the end.
+int sampleUniformInto(unsigned int* seed, int d, int max, int* out, bool sorted) {
+    if (d >= max) {
+        for (int i = 0; i < max; i++) {
+            out[i] = i;
+        }
+        return max;
+    }
+
+    int n = 0;
+    if (d <= SAMPLE_LINEAR_MAX) {
+        for (int j = max - d; j < max; j++) {
+            int t = rand_r(seed) % (j + 1);
+            for (int i = 0; i < n; i++) {
+                if (out[i] == t) {
+                    t = j;
+                    break;
+                }
+            }
+            out[n++] = t;
+        }
+    } else {
+        int slots = 1;
+        while (slots < 2 * d) {
+            slots <<= 1;
+        }
+        int local[SAMPLE_TABLE_SLOTS];
+        int* table = slots <= SAMPLE_TABLE_SLOTS ? local : (int*)malloc(slots * sizeof(int));
+        memset(table, 0xff, slots * sizeof(int));
+        for (int j = max - d; j < max; j++) {
+            int t = rand_r(seed) % (j + 1);
+            if (!tableInsert(table, slots, t)) {
+                // j is larger than anything drawn so far
+                t = j;
+                tableInsert(table, slots, t);
+            }
+            out[n++] = t;
+        }
+        if (table != local) {
+            free(table);
+        }
+    }
+    if (sorted) {
+        qsort(out, n, sizeof(int), compareInts);
+    }
+    return n;
+}
@@ -0,0 +1,240 @@
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+#include "soliton.h"
+
+// 참조가 없어도 지우지 않고 남겨 두는 분포의 수. 짧게 살다 가는 코덱이
+// 같은 매개변수로 계속 만들어질 때 매번 다시 계산하지 않게 합니다.
+#define SOLITON_CACHE_IDLE 16
+
+void solitonDistribution(int n, double **cdf, int *size) {
+    *size = n + 1;
+    *cdf = (double *)malloc(*size * sizeof(double));
+    double *cdf_array = *cdf;
+    cdf_array[0] = 0;
+    cdf_array[1] = 1.0 / n;
+    for (int i = 2; i < *size; i++) {
+        cdf_array[i] = cdf_array[i - 1] + (1.0 / (i * (i - 1)));
+    }
+}
+
+void robustSolitonDistribution(int n, int m, double delta, double **cdf, int *size) {
+    *size = n + 1;
+    *cdf = (double *)malloc(*size * sizeof(double));
+    double *pdf = (double *)malloc(*size * sizeof(double));
+    double *cdf_array = *cdf;
+    cdf_array[0] = 0;
+
+    pdf[1] = 1.0 / n + 1.0 / m;
+    double total = pdf[1];
+    for (int i = 2; i < *size; i++) {
+        pdf[i] = (1.0 / (i * (i - 1)));
+        if (i < m) {
+            pdf[i] += 1.0 / (i * m);
+        }
+        if (i == m) {
+            pdf[i] += log(n / (m * delta)) / m;
+        }
+        total += pdf[i];
+    }
+
+    for (int i = 1; i < *size; i++) {
+        pdf[i] /= total;
+        cdf_array[i] = cdf_array[i - 1] + pdf[i];
+    }
+
+    free(pdf);
+}
+
+void onlineSolitonDistribution(double eps, double **cdf, int *size) {
+    double f = ceil(log(eps * eps / 4) / log(1 - (eps / 2)));
+    *size = (int)f + 1;
+    *cdf = (double *)malloc(*size * sizeof(double));
+    double *cdf_array = *cdf;
+
+    double rho = 1 - ((1 + (1 / f)) / (1 + eps));
+    cdf_array[0] = 0;
+    cdf_array[1] = rho;
+
+    for (int i = 2; i <= (int)f; i++) {
+        double rhoI = ((1 - rho) * f) / ((f - 1) * (i - 1) * i);
+        cdf_array[i] = cdf_array[i - 1] + rhoI;
+    }
+}
+
+static pthread_mutex_t cacheLock = PTHREAD_MUTEX_INITIALIZER;
+static degreeDist* cacheHead = NULL;  // 최근에 쓴 분포가 앞쪽
+static int cacheIdle = 0;             // 참조가 없는 캐시 항목 수
+
+static degreeDist* newDegreeDist(degreeKind kind, double* cdf, int size) {
+    degreeDist* d = (degreeDist*)calloc(1, sizeof(degreeDist));
+    d->kind = kind;
+    d->cdf = cdf;
+    d->size = size;
+    d->table = newAliasTable(cdf, size);
+    d->refs = 1;
+    return d;
+}
+
+static void freeDegreeDist(degreeDist* d) {
+    freeAliasTable(d->table);
+    free(d->cdf);
+    free(d);
+}
+
+static bool sameKey(const degreeDist* a, const degreeDist* b) {
+    return a->kind == b->kind && a->n == b->n && a->m == b->m &&
+           a->delta == b->delta && a->epsilon == b->epsilon;
+}
+
+// 잠금을 잡은 상태에서 호출. 키가 같은 항목을 찾아 목록 맨 앞으로 옮깁니다.
+static degreeDist* findLocked(const degreeDist* key) {
+    degreeDist** link = &cacheHead;
+    for (degreeDist* d = cacheHead; d != NULL; link = &d->next, d = d->next) {
+        if (sameKey(d, key)) {
+            *link = d->next;
+            d->next = cacheHead;
+            cacheHead = d;
+            return d;
+        }
+    }
+    return NULL;
+}
+
+// 잠금을 잡은 상태에서 호출. 참조가 없는 항목 중 가장 오래된 것을 지웁니다.
+static void evictLocked(void) {
+    degreeDist** victim = NULL;
+    for (degreeDist** link = &cacheHead; *link != NULL; link = &(*link)->next) {
+        if ((*link)->refs == 0) {
+            victim = link;
+        }
+    }
+    if (victim != NULL) {
+        degreeDist* d = *victim;
+        *victim = d->next;
+        cacheIdle--;
+        freeDegreeDist(d);
+    }
+}
+
+// 키에 맞는 분포를 캐시에서 찾고, 없으면 잠금 밖에서 계산해 넣습니다.
+// 그 사이 다른 스레드가 먼저 넣었다면 그쪽을 쓰고 방금 만든 것은 버립니다.
+static const degreeDist* acquire(const degreeDist* key) {
+    pthread_mutex_lock(&cacheLock);
+    degreeDist* d = findLocked(key);
+    if (d != NULL) {
+        if (d->refs++ == 0) {
+            cacheIdle--;
+        }
+        pthread_mutex_unlock(&cacheLock);
+        return d;
+    }
+    pthread_mutex_unlock(&cacheLock);
+
+    double* cdf;
+    int size;
+    switch (key->kind) {
+    case DEGREE_SOLITON:
+        solitonDistribution(key->n, &cdf, &size);
+        break;
+    case DEGREE_ROBUST_SOLITON:
+        robustSolitonDistribution(key->n, key->m, key->delta, &cdf, &size);
+        break;
+    default:
+        onlineSolitonDistribution(key->epsilon, &cdf, &size);
+        break;
+    }
+    degreeDist* built = newDegreeDist(key->kind, cdf, size);
+    built->n = key->n;
+    built->m = key->m;
+    built->delta = key->delta;
+    built->epsilon = key->epsilon;
+    built->cached = true;
+
+    pthread_mutex_lock(&cacheLock);
+    d = findLocked(key);
+    if (d != NULL) {
+        if (d->refs++ == 0) {
+            cacheIdle--;
+        }
+    } else {
+        built->next = cacheHead;
+        cacheHead = built;
+        d = built;
+        built = NULL;
+    }
+    pthread_mutex_unlock(&cacheLock);
+
+    if (built != NULL) {
+        freeDegreeDist(built);
+    }
+    return d;
+}
+
+const degreeDist* acquireSoliton(int n) {
+    degreeDist key = {.kind = DEGREE_SOLITON, .n = n};
+    return acquire(&key);
+}
+
+const degreeDist* acquireRobustSoliton(int n, int m, double delta) {
+    degreeDist key = {.kind = DEGREE_ROBUST_SOLITON, .n = n, .m = m, .delta = delta};
+    return acquire(&key);
+}
+
+const degreeDist* acquireOnlineSoliton(double epsilon) {
+    degreeDist key = {.kind = DEGREE_ONLINE_SOLITON, .epsilon = epsilon};
+    return acquire(&key);
+}
+
+// 호출자가 만든 CDF(인덱스 = 차수, malloc)를 넘겨받아 캐시 밖의 분포로 감쌉니다.
+const degreeDist* wrapDegreeCDF(double* cdf, int size) {
+    return newDegreeDist(DEGREE_CUSTOM, cdf, size);
+}
+
+const degreeDist* retainDegreeDist(const degreeDist* d) {
+    degreeDist* dist = (degreeDist*)d;
+    pthread_mutex_lock(&cacheLock);
+    dist->refs++;
+    pthread_mutex_unlock(&cacheLock);
+    return d;
+}
+
+// 참조를 반납합니다. 캐시 밖의 분포는 바로 해제하고, 캐시 항목은 남겨 두되
+// 참조 없는 항목이 SOLITON_CACHE_IDLE개를 넘으면 가장 오래된 것을 지웁니다.
+void releaseDegreeDist(const degreeDist* d) {
+    if (d == NULL) {
+        return;
+    }
+    degreeDist* dist = (degreeDist*)d;
+    pthread_mutex_lock(&cacheLock);
+    bool last = --dist->refs == 0;
+    bool cached = dist->cached;
+    if (last && cached) {
+        cacheIdle++;
+        if (cacheIdle > SOLITON_CACHE_IDLE) {
+            evictLocked();
+        }
+    }
+    pthread_mutex_unlock(&cacheLock);
+
+    if (last && !cached) {
+        freeDegreeDist(dist);
+    }
+}
+
+// 참조가 없는 캐시 항목을 모두 해제합니다.
+void trimDegreeDistCache(void) {
+    pthread_mutex_lock(&cacheLock);
+    degreeDist** link = &cacheHead;
+    while (*link != NULL) {
+        degreeDist* d = *link;
+        if (d->refs == 0) {
+            *link = d->next;
+            cacheIdle--;
+            freeDegreeDist(d);
+        } else {
+            link = &d->next;
+        }
+    }
+    pthread_mutex_unlock(&cacheLock);
+}
@@ -0,0 +1,31 @@
+#include <stdio.h>
+#include <inttypes.h>
+#include "stats.h"
+
+// 이 빌드에서 디코더가 카운터를 갱신하는지 여부
+bool decoderStatsEnabled(void) {
+#ifdef FOUNTAIN_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+// stats를 JSON 한 줄(줄바꿈 포함)로 buffer에 씁니다. codec은 레이블로 그대로 들어가므로
+// 따옴표나 역슬래시가 없어야 합니다. 돌려주는 값은 snprintf와 같이 필요한 길이이며,
+// capacity 이상이면 잘린 것입니다.
+int formatDecoderStats(char* buffer, size_t capacity, const char* codec, const decoderStats* stats) {
+    return snprintf(buffer, capacity,
+                    "{\"codec\":\"%s\",\"enabled\":%s,\"symbols_added\":%" PRIu64
+                    ",\"redundant_symbols\":%" PRIu64 ",\"xor_bytes\":%" PRIu64
+                    ",\"row_merges\":%" PRIu64 ",\"peeled\":%" PRIu64 ",\"eliminated\":%" PRIu64
+                    ",\"inactivated\":%" PRIu64 ",\"rank\":%d,\"num_cols\":%d"
+                    ",\"symbols_at_determined\":%" PRIu64 ",\"add_ns\":%" PRIu64
+                    ",\"peel_ns\":%" PRIu64 ",\"eliminate_ns\":%" PRIu64 ",\"backsub_ns\":%" PRIu64
+                    ",\"peak_bytes\":%zu}\n",
+                    codec, decoderStatsEnabled() ? "true" : "false", stats->symbolsAdded,
+                    stats->redundantSymbols, stats->xorBytes, stats->rowMerges, stats->peeled,
+                    stats->eliminated, stats->inactivated, stats->rank, stats->numCols,
+                    stats->symbolsAtDetermined, stats->addNanos, stats->peelNanos,
+                    stats->eliminateNanos, stats->backsubNanos, stats->peakBytes);
+}
@@ -0,0 +1,93 @@
+#include <stdlib.h>
+#include <string.h>
+#include "symbols.h"
+
+#define SYMBOL_MATRIX_ALIGN 64
+
+// 0으로 채워진 기호 행렬 생성. alignment가 0 이하이면 패딩 없이 symbolSize 간격입니다.
+symbolMatrix* newSymbolMatrix(int count, int symbolSize, int alignment) {
+    symbolMatrix* m = (symbolMatrix*)malloc(sizeof(symbolMatrix));
+    if (alignment < 1) {
+        alignment = 1;
+    }
+    m->count = count;
+    m->symbolSize = symbolSize;
+    m->stride = (symbolSize + alignment - 1) / alignment * alignment;
+    m->owned = true;
+
+    size_t bytes = (size_t)count * m->stride;
+    bytes = (bytes + SYMBOL_MATRIX_ALIGN - 1) / SYMBOL_MATRIX_ALIGN * SYMBOL_MATRIX_ALIGN;
+    m->data = (uint8_t*)aligned_alloc(SYMBOL_MATRIX_ALIGN, bytes > 0 ? bytes : SYMBOL_MATRIX_ALIGN);
+    memset(m->data, 0, bytes);
+    return m;
+}
+
+// 호출자의 버퍼를 symbolSize 간격의 기호 count개로 보는 뷰. 버퍼는 복사하지도
+// 해제하지도 않습니다.
+symbolMatrix* viewSymbols(uint8_t* buffer, int count, int symbolSize) {
+    symbolMatrix* m = (symbolMatrix*)malloc(sizeof(symbolMatrix));
+    m->data = buffer;
+    m->count = count;
+    m->symbolSize = symbolSize;
+    m->stride = symbolSize;
+    m->owned = false;
+    return m;
+}
+
+void freeSymbolMatrix(symbolMatrix* m) {
+    if (m != NULL) {
+        if (m->owned) {
+            free(m->data);
+        }
+        free(m);
+    }
+}
+
+// 메시지를 numSymbols개의 기호로 나눕니다. 앞쪽 기호는 한 바이트 긴(long) 블록,
+// 뒤쪽은 짧은(short) 블록이고, 짧은 블록은 0으로 채워 길이를 맞춥니다.
+// 메시지가 나누어떨어지고 정렬 패딩이 필요 없으면 복사 없이 메시지를 그대로
+// 감싼 읽기 전용 뷰를 돌려줍니다.
+symbolMatrix* partitionSymbols(const uint8_t* message, int messageLength, int numSymbols, int alignment) {
+    int lenShort = messageLength / numSymbols;
+    int numLong = messageLength - lenShort * numSymbols;
+    int symbolSize = numLong > 0 ? lenShort + 1 : lenShort;
+
+    if (numLong == 0 && (alignment <= 1 || symbolSize % alignment == 0)) {
+        return viewSymbols((uint8_t*)message, numSymbols, symbolSize);
+    }
+
+    symbolMatrix* m = newSymbolMatrix(numSymbols, symbolSize, alignment);
+    for (int i = 0, offset = 0; i < numSymbols; i++) {
+        int n = i < numLong ? lenShort + 1 : lenShort;
+        memcpy(symbolAt(m, i), message + offset, n);
+        offset += n;
+    }
+    return m;
+}
+
+// 디코딩 결과를 받을 버퍼의 크기. 기호 numSymbols개를 패딩 포함 길이로 그대로
+// 담을 수 있어야 하므로 messageLength보다 최대 numSymbols-1 바이트 큽니다.
+size_t symbolBufferSize(int messageLength, int numSymbols) {
+    return (size_t)numSymbols * ((messageLength + numSymbols - 1) / numSymbols);
+}
+
+// partitionSymbols의 역. viewSymbols로 감싼 버퍼에 기호가 풀려 있을 때 짧은 블록의
+// 패딩을 제자리에서 걷어내 버퍼 앞쪽 messageLength 바이트를 원본 메시지로 만듭니다.
+// 메시지가 나누어떨어지면 아무것도 옮기지 않습니다.
+void compactSymbols(symbolMatrix* m, int numSymbols, int messageLength) {
+    int lenShort = messageLength / numSymbols;
+    int numLong = messageLength - lenShort * numSymbols;
+    if (numLong == 0 && m->stride == lenShort) {
+        return;
+    }
+
+    size_t offset = 0;
+    for (int i = 0; i < numSymbols; i++) {
+        int n = i < numLong ? lenShort + 1 : lenShort;
+        uint8_t* symbol = symbolAt(m, i);
+        if (symbol != m->data + offset) {
+            memmove(m->data + offset, symbol, n);
+        }
+        offset += n;
+    }
+}
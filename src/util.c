@@ -5,60 +5,10 @@
 #include <stdint.h>
 #include <string.h>
 #include "constants.c"
+#include "sample.h"
+#include "soliton.h"
 
 
-void solitonDistribution(int n, double **cdf, int *size) {
-    *size = n + 1;
-    *cdf = (double *)malloc(*size * sizeof(double));
-    double *cdf_array = *cdf;
-    cdf_array[1] = 1.0 / n;
-    for (int i = 2; i < *size; i++) {
-        cdf_array[i] = cdf_array[i - 1] + (1.0 / (i * (i - 1)));
-    }
-}
-
-void robustSolitonDistribution(int n, int m, double delta, double **cdf, int *size) {
-    *size = n + 1;
-    *cdf = (double *)malloc(*size * sizeof(double));
-    double *pdf = (double *)malloc(*size * sizeof(double));
-    double *cdf_array = *cdf;
-
-    pdf[1] = 1.0 / n + 1.0 / m;
-    double total = pdf[1];
-    for (int i = 2; i < *size; i++) {
-        pdf[i] = (1.0 / (i * (i - 1)));
-        if (i < m) {
-            pdf[i] += 1.0 / (i * m);
-        }
-        if (i == m) {
-            pdf[i] += log(n / (m * delta)) / m;
-        }
-        total += pdf[i];
-    }
-
-    for (int i = 1; i < *size; i++) {
-        pdf[i] /= total;
-        cdf_array[i] = cdf_array[i - 1] + pdf[i];
-    }
-
-    free(pdf);
-}
-
-void onlineSolitonDistribution(double eps, double **cdf, int *size) {
-    double f = ceil(log(eps * eps / 4) / log(1 - (eps / 2)));
-    *size = (int)f + 1;
-    *cdf = (double *)malloc(*size * sizeof(double));
-    double *cdf_array = *cdf;
-
-    double rho = 1 - ((1 + (1 / f)) / (1 + eps));
-    cdf_array[1] = rho;
-
-    for (int i = 2; i <= (int)f; i++) {
-        double rhoI = ((1 - rho) * f) / ((f - 1) * (i - 1) * i);
-        cdf_array[i] = cdf_array[i - 1] + rhoI;
-    }
-}
-
 int pickDegree(double r, double *cdf, int size) {
     int low = 1, high = size - 1;
     while (low < high) {
@@ -73,30 +23,9 @@ int pickDegree(double r, double *cdf, int size) {
 }
 
 void sampleUniform(int num, int max, int **picks, int *size) {
-    if (num >= max) {
-        *size = max;
-        *picks = (int *)malloc(max * sizeof(int));
-        for (int i = 0; i < max; i++) {
-            (*picks)[i] = i;
-        }
-        return;
-    }
-
-    *size = num;
-    *picks = (int *)malloc(num * sizeof(int));
-    bool *seen = (bool *)calloc(max, sizeof(bool));
-
-    for (int i = 0; i < num; i++) {
-        int p;
-        do {
-            p = rand() % max;
-        } while (seen[p]);
-        (*picks)[i] = p;
-        seen[p] = true;
-    }
-
-    free(seen);
-    qsort(*picks, num, sizeof(int), (int (*)(const void *, const void *))strcmp);
+    unsigned int seed = (unsigned int)rand();
+    *picks = (int *)malloc((num < max ? num : max) * sizeof(int));
+    *size = sampleUniformInto(&seed, num, max, *picks, true);
 }
 
 void partition(int i, int j, int *il, int *is, int *jl, int *js) {
@@ -121,40 +50,25 @@ int factorial(int x) {
     return f;
 }
 
+int choose(int n, int k);
+
 int centerBinomial(int x) {
     return choose(x, x / 2);
 }
 
 int choose(int n, int k) {
+    if (k < 0 || k > n) {
+        return 0;
+    }
     if (k > n / 2) {
         k = n - k;
     }
-    int *numerator = (int *)malloc((n - k) * sizeof(int));
-    int *denominator = (int *)malloc((n - k) * sizeof(int));
-
-    for (int i = k + 1, j = 1; i <= n; i++, j++) {
-        numerator[j - 1] = i;
-        denominator[j - 1] = j;
+    // Every partial product is itself a binomial coefficient, so the division is exact
+    int64_t f = 1;
+    for (int i = 1; i <= k; i++) {
+        f = f * (n - k + i) / i;
     }
-
-    for (int j = (n - k) - 1; j > 0; j--) {
-        for (int i = (n - k) - 1; i >= 0; i--) {
-            if (numerator[i] % denominator[j] == 0) {
-                numerator[i] /= denominator[j];
-                denominator[j] = 1;
-                break;
-            }
-        }
-    }
-
-    int f = 1;
-    for (int i = 0; i < (n - k); i++) {
-        f *= numerator[i];
-    }
-
-    free(numerator);
-    free(denominator);
-    return f;
+    return (int)f;
 }
 
 bool bitSet(uint32_t x, uint32_t b) {
@@ -0,0 +1,140 @@
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include "../include/xor.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define XOR_X86 1
+#endif
+
+typedef void (*xorKernel)(uint8_t*, const uint8_t* const*, int, size_t, bool);
+
+// 64-bit scalar loop over [i, length). Also finishes the tails left by the vector kernels.
+static void xorRange(uint8_t* dst, const uint8_t* const* srcs, int numSrcs, size_t i, size_t length, bool gather) {
+    for (; i + 8 <= length; i += 8) {
+        uint64_t acc = 0, w;
+        if (!gather) {
+            memcpy(&acc, dst + i, 8);
+        }
+        for (int s = 0; s < numSrcs; s++) {
+            memcpy(&w, srcs[s] + i, 8);
+            acc ^= w;
+        }
+        memcpy(dst + i, &acc, 8);
+    }
+    for (; i < length; i++) {
+        uint8_t acc = gather ? 0 : dst[i];
+        for (int s = 0; s < numSrcs; s++) {
+            acc ^= srcs[s][i];
+        }
+        dst[i] = acc;
+    }
+}
+
+static void xorKernel_Scalar64(uint8_t* dst, const uint8_t* const* srcs, int numSrcs, size_t length, bool gather) {
+    xorRange(dst, srcs, numSrcs, 0, length, gather);
+}
+
+#ifdef XOR_X86
+
+__attribute__((target("sse2")))
+static void xorKernel_SSE2(uint8_t* dst, const uint8_t* const* srcs, int numSrcs, size_t length, bool gather) {
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i acc = gather ? _mm_setzero_si128() : _mm_loadu_si128((const __m128i*)(dst + i));
+        for (int s = 0; s < numSrcs; s++) {
+            acc = _mm_xor_si128(acc, _mm_loadu_si128((const __m128i*)(srcs[s] + i)));
+        }
+        _mm_storeu_si128((__m128i*)(dst + i), acc);
+    }
+    xorRange(dst, srcs, numSrcs, i, length, gather);
+}
+
+__attribute__((target("avx2")))
+static void xorKernel_AVX2(uint8_t* dst, const uint8_t* const* srcs, int numSrcs, size_t length, bool gather) {
+    size_t i = 0;
+    for (; i + 64 <= length; i += 64) {
+        __m256i a0 = gather ? _mm256_setzero_si256() : _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i a1 = gather ? _mm256_setzero_si256() : _mm256_loadu_si256((const __m256i*)(dst + i + 32));
+        for (int s = 0; s < numSrcs; s++) {
+            a0 = _mm256_xor_si256(a0, _mm256_loadu_si256((const __m256i*)(srcs[s] + i)));
+            a1 = _mm256_xor_si256(a1, _mm256_loadu_si256((const __m256i*)(srcs[s] + i + 32)));
+        }
+        _mm256_storeu_si256((__m256i*)(dst + i), a0);
+        _mm256_storeu_si256((__m256i*)(dst + i + 32), a1);
+    }
+    for (; i + 32 <= length; i += 32) {
+        __m256i acc = gather ? _mm256_setzero_si256() : _mm256_loadu_si256((const __m256i*)(dst + i));
+        for (int s = 0; s < numSrcs; s++) {
+            acc = _mm256_xor_si256(acc, _mm256_loadu_si256((const __m256i*)(srcs[s] + i)));
+        }
+        _mm256_storeu_si256((__m256i*)(dst + i), acc);
+    }
+    xorRange(dst, srcs, numSrcs, i, length, gather);
+}
+
+__attribute__((target("avx512f")))
+static void xorKernel_AVX512(uint8_t* dst, const uint8_t* const* srcs, int numSrcs, size_t length, bool gather) {
+    size_t i = 0;
+    for (; i + 64 <= length; i += 64) {
+        __m512i acc = gather ? _mm512_setzero_si512() : _mm512_loadu_si512((const void*)(dst + i));
+        for (int s = 0; s < numSrcs; s++) {
+            acc = _mm512_xor_si512(acc, _mm512_loadu_si512((const void*)(srcs[s] + i)));
+        }
+        _mm512_storeu_si512((void*)(dst + i), acc);
+    }
+    xorRange(dst, srcs, numSrcs, i, length, gather);
+}
+
+#endif // XOR_X86
+
+static xorKernel selectedKernel = xorKernel_Scalar64;
+static const char* selectedKernelName = "scalar64";
+static pthread_once_t kernelOnce = PTHREAD_ONCE_INIT;
+
+// 실행 중인 CPU에서 지원하는 가장 넓은 커널을 선택합니다.
+static void selectKernel(void) {
+#ifdef XOR_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        selectedKernel = xorKernel_AVX512;
+        selectedKernelName = "avx512";
+    } else if (__builtin_cpu_supports("avx2")) {
+        selectedKernel = xorKernel_AVX2;
+        selectedKernelName = "avx2";
+    } else if (__builtin_cpu_supports("sse2")) {
+        selectedKernel = xorKernel_SSE2;
+        selectedKernelName = "sse2";
+    }
+#endif
+}
+
+static xorKernel kernel(void) {
+    pthread_once(&kernelOnce, selectKernel);
+    return selectedKernel;
+}
+
+void xorBytes(uint8_t* dst, const uint8_t* src, size_t length) {
+    kernel()(dst, &src, 1, length, false);
+}
+
+void xorBytesMulti(uint8_t* dst, const uint8_t* const* srcs, int numSrcs, size_t length) {
+    if (numSrcs <= 0) {
+        return;
+    }
+    kernel()(dst, srcs, numSrcs, length, false);
+}
+
+void xorBytesGather(uint8_t* dst, const uint8_t* const* srcs, int numSrcs, size_t length) {
+    if (numSrcs <= 0) {
+        memset(dst, 0, length);
+        return;
+    }
+    kernel()(dst, srcs, numSrcs, length, true);
+}
+
+const char* xorKernelName(void) {
+    pthread_once(&kernelOnce, selectKernel);
+    return selectedKernelName;
+}